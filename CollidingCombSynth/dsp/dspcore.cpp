@@ -294,11 +294,17 @@ void DSPCORE_NAME::noteOn(int32_t noteId, int16_t pitch, float tuning, float vel
 
   noteIndices.resize(0);
 
+  // Reuse note of same ID. This happens when a key held by pedal is struck again.
+  for (uint8_t index = 0; index < nVoice; ++index) {
+    if (noteIndices.size() >= nUnison) break;
+    if (notes[index].id == noteId && notes[index].state != NoteState::rest)
+      noteIndices.push_back(index);
+  }
+
   // Pick up note from resting one.
   for (uint8_t index = 0; index < nVoice; ++index) {
-    if (notes[index].id == noteId) noteIndices.push_back(index);
-    if (notes[index].state == NoteState::rest) noteIndices.push_back(index);
     if (noteIndices.size() >= nUnison) break;
+    if (notes[index].state == NoteState::rest) noteIndices.push_back(index);
   }
 
   // If there aren't enought resting note, pick up from most quiet one.
@@ -310,6 +316,7 @@ void DSPCORE_NAME::noteOn(int32_t noteId, int16_t pitch, float tuning, float vel
     });
 
     for (auto &index : voiceIndices) {
+      if (notes[index].state == NoteState::rest || notes[index].id == noteId) continue;
       fillTransitionBuffer(index);
       noteIndices.push_back(index);
       if (noteIndices.size() >= nUnison) break;
@@ -141,12 +141,10 @@ struct Scales {
 };
 
 struct GlobalParameter : public ParameterInterface {
-  std::vector<std::unique_ptr<ValueInterface>> value;
+  ParameterStore<ParameterID::ID_ENUM_LENGTH> value;
 
   GlobalParameter()
   {
-    value.resize(ParameterID::ID_ENUM_LENGTH);
-
     using ID = ParameterID::ID;
     using LinearValue = FloatValue<SomeDSP::LinearScale<double>>;
     using LogValue = FloatValue<SomeDSP::LogScale<double>>;
@@ -154,19 +152,17 @@ struct GlobalParameter : public ParameterInterface {
     value[ID::bypass] = std::make_unique<IntValue>(
       false, Scales::boolScale, "bypass", kParameterIsAutomable | kParameterIsBoolean);
 
-    std::string frequencyLabel("frequency");
+    static constexpr IndexedName<nDelay> frequencyLabel("frequency");
     for (size_t idx = 0; idx < nDelay; ++idx) {
-      auto indexStr = std::to_string(idx);
       value[ID::frequency0 + idx] = std::make_unique<LogValue>(
         Scales::frequency.invmap(100.0 + 20.0 * idx), Scales::frequency,
-        (frequencyLabel + indexStr).c_str(), kParameterIsAutomable);
+        frequencyLabel[idx], kParameterIsAutomable);
     }
 
-    std::string combTimeLabel("combTime");
+    static constexpr IndexedName<nComb> combTimeLabel("combTime");
     for (size_t idx = 0; idx < nComb; ++idx) {
-      auto indexStr = std::to_string(idx);
       value[ID::combTime0 + idx] = std::make_unique<LinearValue>(
-        0.5, Scales::combTime, (combTimeLabel + indexStr).c_str(), kParameterIsAutomable);
+        0.5, Scales::combTime, combTimeLabel[idx], kParameterIsAutomable);
     }
 
     value[ID::gain] = std::make_unique<LogValue>(
@@ -26,6 +26,7 @@
 
 #include "DistrhoPlugin.hpp"
 #include "dsp/dspcore.hpp"
+#include "../common/midi.hpp"
 
 START_NAMESPACE_DISTRHO
 
@@ -49,8 +50,6 @@ public:
     dsp->param.validate();
 
     sampleRateChanged(getSampleRate());
-    lastNoteId.reserve(dsp->maxVoice + 1);
-    alreadyRecievedNote.reserve(dsp->maxVoice);
   }
 
 protected:
@@ -91,9 +90,17 @@ protected:
 
   void loadProgram(uint32_t index) override { dsp->param.loadProgram(index); }
 
-  void sampleRateChanged(double newSampleRate) { dsp->setup(newSampleRate); }
+  void sampleRateChanged(double newSampleRate)
+  {
+    dsp->setup(newSampleRate);
+    noteIdTable.reset();
+  }
   void activate() {}
-  void deactivate() { dsp->reset(); }
+  void deactivate()
+  {
+    dsp->reset();
+    noteIdTable.reset();
+  }
 
   void handleMidi(const MidiEvent ev)
   {
@@ -101,28 +108,22 @@ protected:
 
     switch (ev.data[0] & 0xf0) {
       // Note off.
-      case 0x80: {
-        auto it = std::find_if(
-          lastNoteId.begin(), lastNoteId.end(),
-          [&](const std::pair<uint8_t, uint32_t> &p) { return p.first == ev.data[1]; });
-        if (it == std::end(lastNoteId)) break;
-        dsp->pushMidiNote(false, ev.frame, it->second, 0, 0, 0);
-        lastNoteId.erase(it);
-      } break;
-
-      // Note on. data[1]: note number, data[2] velocity.
+      case 0x80:
+        noteIdTable.noteOff(*dsp, ev.frame, ev.data[1]);
+        break;
+
+      // Note on. data[1]: note number, data[2] velocity. Velocity 0 is note-off.
       case 0x90:
-        if (ev.data[2] > 0) {
-          auto it = std::find_if(
-            alreadyRecievedNote.begin(), alreadyRecievedNote.end(),
-            [&](const uint8_t &noteNo) { return noteNo == ev.data[1]; });
-          if (it != std::end(alreadyRecievedNote)) break;
-          dsp->pushMidiNote(
-            true, ev.frame, noteId, ev.data[1], 0.0f, ev.data[2] / float(INT8_MAX));
-          lastNoteId.push_back(std::pair<uint8_t, uint32_t>(ev.data[1], noteId));
-          alreadyRecievedNote.push_back(ev.data[1]);
-          noteId += 1;
-        }
+        if (ev.data[2] > 0)
+          noteIdTable.noteOn(*dsp, ev.frame, ev.data[1], ev.data[2]);
+        else
+          noteIdTable.noteOff(*dsp, ev.frame, ev.data[1]);
+        break;
+
+      // Control change. data[1]: control number, data[2]: value.
+      case 0xb0:
+        noteIdTable.controlChange(
+          *dsp, ev.frame, ev.data[0] & 0x0f, ev.data[1], ev.data[2]);
         break;
 
       // Pitch bend. Center is 8192 (0x2000).
@@ -147,11 +148,14 @@ protected:
     if (dsp->param.value[ParameterID::bypass]->getInt()) return;
 
     const auto timePos = getTimePosition();
-    if (!wasPlaying && timePos.playing) dsp->startup();
+    if (!wasPlaying && timePos.playing) {
+      dsp->startup();
+      noteIdTable.resetPedal(*dsp, 0);
+    }
     wasPlaying = timePos.playing;
 
     for (size_t i = 0; i < midiEventCount; ++i) handleMidi(midiEvents[i]);
-    alreadyRecievedNote.resize(0);
+    noteIdTable.endCycle();
 
     dsp->setParameters(timePos.bbt.beatsPerMinute);
     dsp->process(frames, outputs[0], outputs[1]);
@@ -160,9 +164,7 @@ protected:
 private:
   std::unique_ptr<DSPInterface> dsp;
   bool wasPlaying = false;
-  uint32_t noteId = 0;
-  std::vector<std::pair<uint8_t, uint32_t>> lastNoteId;
-  std::vector<uint8_t> alreadyRecievedNote;
+  NoteIdTable noteIdTable;
 
   DISTRHO_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CollidingCombSynth)
 };
@@ -46,6 +46,16 @@
   #error Unsupported instruction set
 #endif
 
+// Range of MPE timbre (CC 74) applied to table lowpass, in semitones.
+constexpr float timbreLowpassRange = 36.0f;
+
+// Release time of notes dropped by CPU governor. In seconds.
+constexpr float governorFadeTime = 0.02f;
+
+// When `unisonReduceInterpolation` is on, unison voices from this index use one step
+// cheaper interpolation than `oscInterpolation`.
+constexpr size_t nFullQualityUnison = 4;
+
 inline float clamp(float value, float min, float max)
 {
   return (value < min) ? min : (value > max) ? max : value;
@@ -76,6 +86,7 @@ void NOTE_NAME::noteOn(
   float velocity,
   float pan,
   float phase,
+  int32_t interpType,
   NoteProcessInfo &info,
   std::array<PROCESSING_UNIT_NAME, nUnit> &units,
   GlobalParameter &param)
@@ -104,6 +115,10 @@ void NOTE_NAME::noteOn(
   }
 
   unit.notePan.insert(vecIndex, pan);
+  unit.osc.setInterpType(vecIndex, interpType);
+  unit.isNoteStarted = true;
+
+  setExpression(units, NoteExpression(), true);
 
   unit.gainEnvelope.reset(vecIndex);
   unit.lowpassEnvelope.reset(
@@ -127,10 +142,27 @@ void NOTE_NAME::release(std::array<PROCESSING_UNIT_NAME, nUnit> &units)
 
 void NOTE_NAME::release(std::array<PROCESSING_UNIT_NAME, nUnit> &units, float seconds)
 {
+  if (state == NoteState::rest) return;
   release(units);
   units[arrayIndex].gainEnvelope.setRelease(vecIndex, seconds);
 }
 
+void NOTE_NAME::setExpression(
+  std::array<PROCESSING_UNIT_NAME, nUnit> &units,
+  const NoteExpression &expression,
+  bool reset)
+{
+  auto &unit = units[arrayIndex];
+  if (reset) {
+    unit.noteBend.reset(vecIndex, expression.bend);
+    unit.notePressure.reset(vecIndex, expression.pressure);
+    unit.noteTimbre.reset(vecIndex, expression.timbre);
+  }
+  unit.noteBend.push(vecIndex, expression.bend);
+  unit.notePressure.push(vecIndex, expression.pressure);
+  unit.noteTimbre.push(vecIndex, expression.timbre);
+}
+
 void NOTE_NAME::rest() { state = NoteState::rest; }
 
 bool NOTE_NAME::isAttacking(std::array<PROCESSING_UNIT_NAME, nUnit> &units)
@@ -138,6 +170,11 @@ bool NOTE_NAME::isAttacking(std::array<PROCESSING_UNIT_NAME, nUnit> &units)
   return units[arrayIndex].gainEnvelope.isAttacking(vecIndex);
 }
 
+bool NOTE_NAME::isTerminated(std::array<PROCESSING_UNIT_NAME, nUnit> &units)
+{
+  return units[arrayIndex].gainEnvelope.isTerminated(vecIndex);
+}
+
 float NOTE_NAME::getGain(std::array<PROCESSING_UNIT_NAME, nUnit> &units)
 {
   return units[arrayIndex].gain[vecIndex];
@@ -174,6 +211,8 @@ void DSPCORE_NAME::setup(double sampleRate)
 
   startup();
   prepareRefresh = true;
+
+  param.value.markChanged();
 }
 
 void PROCESSING_UNIT_NAME::reset()
@@ -191,6 +230,8 @@ void DSPCORE_NAME::reset()
   for (auto &unit : units) unit.reset();
   info.reset();
   startup();
+
+  param.value.markChanged();
 }
 
 void DSPCORE_NAME::startup()
@@ -204,11 +245,21 @@ void DSPCORE_NAME::startup()
   }
 }
 
+// `isNoteStarted` is set on note-on, because gain envelope times adapt to the frequency
+// of each lane.
 void PROCESSING_UNIT_NAME::setParameters(
-  float sampleRate, NoteProcessInfo &info, GlobalParameter &param)
+  float sampleRate, NoteProcessInfo &info, GlobalParameter &param, bool isEnvelopeChanged)
 {
   using ID = ParameterID::ID;
 
+  if (!isEnvelopeChanged && !isNoteStarted) {
+    gainEnvelope.setSustain(param.value[ID::gainS]->getFloat());
+    lowpassEnvelope.setSustain(param.value[ID::tableLowpassS]->getFloat());
+    pitchEnvelope.setSustain(param.value[ID::pitchS]->getFloat());
+    return;
+  }
+  isNoteStarted = false;
+
   gainEnvelope.set(
     param.value[ID::gainA]->getFloat(), param.value[ID::gainD]->getFloat(),
     param.value[ID::gainS]->getFloat(), param.value[ID::gainR]->getFloat(),
@@ -229,6 +280,10 @@ void DSPCORE_NAME::setParameters(float tempo)
 {
   using ID = ParameterID::ID;
 
+  param.value.consumeChanged();
+
+  tableWorker.receive();
+
   SmootherCommon<float>::setTime(param.value[ID::smoothness]->getFloat());
 
   interpMasterGain.push(param.value[ID::gain]->getFloat());
@@ -255,16 +310,38 @@ void DSPCORE_NAME::setParameters(float tempo)
   info.lfoPitchAmount.push(param.value[ID::lfoPitchAmount]->getFloat());
   info.lfoLowpass.push(param.value[ID::lfoLowpass]->getFloat());
 
-  for (auto &unit : units) unit.setParameters(sampleRate, info, param);
+  // Envelope times take a few `pow` per unit. Only recompute them when the envelope
+  // parameters or the pitch used for their frequency adaptation are changed.
+  const std::array<float, 3> pitchInfo{
+    info.masterPitch.getValue(), info.equalTemperament.getValue(),
+    info.pitchA4Hz.getValue()};
+  const bool isEnvelopeChanged = param.value.isChanged(ID::gainA, ID::gainR)
+    || param.value.isChanged(ID::pitchA, ID::pitchR)
+    || param.value.isChanged(ID::tableLowpassA, ID::tableLowpassR)
+    || pitchInfo != envelopePitchInfo;
+  envelopePitchInfo = pitchInfo;
+
+  for (auto &unit : units) unit.setParameters(sampleRate, info, param, isEnvelopeChanged);
 
   nVoice = 16 * (param.value[ID::nVoice]->getInt() + 1);
   if (nVoice > notes.size()) nVoice = notes.size();
 
-  if (prepareRefresh || (!isLFORefreshed && param.value[ID::refreshLFO]->getInt()))
+  // CPU governor halves voices for each level.
+  const auto governorLevel = param.value[ID::cpuGovernorLevel]->getInt();
+  if (governorLevel > 0) {
+    nVoice = std::max<size_t>(nVoice >> governorLevel, 16);
+    fadeOutExcessNotes();
+  }
+
+  if (
+    isLfoRefreshRequested.exchange(false) || prepareRefresh
+    || (!isLFORefreshed && param.value[ID::refreshLFO]->getInt()))
     refreshLfo();
   isLFORefreshed = param.value[ID::refreshLFO]->getInt();
 
-  if (prepareRefresh || (!isTableRefeshed && param.value[ID::refreshTable]->getInt()))
+  if (
+    isTableRefreshRequested.exchange(false) || prepareRefresh || isTableRequestPending
+    || (!isTableRefeshed && param.value[ID::refreshTable]->getInt()))
     refreshTable();
   isTableRefeshed = param.value[ID::refreshTable]->getInt();
 
@@ -273,7 +350,7 @@ void DSPCORE_NAME::setParameters(float tempo)
 
 std::array<float, 2> PROCESSING_UNIT_NAME::process(
   float sampleRate,
-  Wavetable<tableSize, nOvertone> &wavetable,
+  const Wavetable<tableSize, nOvertone> &wavetable,
   LfoWavetable<lfoTableSize> &lfoWavetable,
   NoteProcessInfo &info)
 {
@@ -282,7 +359,7 @@ std::array<float, 2> PROCESSING_UNIT_NAME::process(
   lfoSmoother.setP(info.lfoLowpass.getValue());
   lfoSig = lfoSmoother.process(lfoSig);
 
-  pitch = lfoSig + notePitch + info.masterPitch.getValue()
+  pitch = lfoSig + notePitch + noteBend.process() + info.masterPitch.getValue()
     + info.pitchEnvelopeAmount.getValue() * pitchEnvelope.process();
   osc.setFrequency(
     sampleRate,
@@ -294,11 +371,12 @@ std::array<float, 2> PROCESSING_UNIT_NAME::process(
   float lpCutoff = info.tableLowpass.getValue();
   float lpPt = lpCutoff * 128.0f; // 128 comes from midi note number range + 1.
   lowpassPitch = (lpPt + lpKey * (lpCutoff * (float(nTable) - pitch) - lpPt))
-    - lowpassEnvelope.process() * info.tableLowpassEnvelopeAmount.getValue();
+    - lowpassEnvelope.process() * info.tableLowpassEnvelopeAmount.getValue()
+    - timbreLowpassRange * noteTimbre.process();
   lowpassPitch = select(lowpassPitch < 0.0f, 0.0f, lowpassPitch);
-  Vec16f sig = osc.processCubic(lowpassPitch + pitch, wavetable.table);
+  Vec16f sig = osc.processCubic(lowpassPitch + pitch, wavetable.data);
 
-  gain = velocity * gainEnvelope.process();
+  gain = velocity * gainEnvelope.process() * (1.0f + notePressure.process());
   isActive = horizontal_add(gain) != 0;
 
   gain1 = gain * notePan;
@@ -312,7 +390,9 @@ std::array<float, 2> PROCESSING_UNIT_NAME::process(
 
 void DSPCORE_NAME::process(const size_t length, float *out0, float *out1)
 {
-  if (wavetable.isRefreshing) {
+  // Silent only until the first table is built.
+  const auto &wavetable = tableWorker.get();
+  if (wavetable == nullptr) {
     for (int i = 0; i < length; ++i) {
       processMidiNote(i);
       out0[i] = 0;
@@ -342,7 +422,7 @@ void DSPCORE_NAME::process(const size_t length, float *out0, float *out1)
 
     for (auto &unit : units) {
       if (!unit.isActive) continue;
-      auto sig = unit.process(sampleRate, wavetable, lfoWavetable, info);
+      auto sig = unit.process(sampleRate, *wavetable, lfoWavetable, info);
       frame[0] += sig[0];
       frame[1] += sig[1];
     }
@@ -359,6 +439,8 @@ void DSPCORE_NAME::process(const size_t length, float *out0, float *out1)
     out0[i] = masterGain * frame[0];
     out1[i] = masterGain * frame[1];
   }
+
+  restTerminatedNotes();
 }
 
 enum UnisonPanType {
@@ -374,6 +456,49 @@ enum UnisonPanType {
   unisonPanShuffle
 };
 
+// Returns lanes of released notes to resting pool. Checked once per block.
+void DSPCORE_NAME::restTerminatedNotes()
+{
+  for (auto &note : notes) {
+    if (note.state == NoteState::release && note.isTerminated(units)) note.rest();
+  }
+}
+
+/*
+Resting notes are picked from the unit which has the most busy lanes. This packs
+notes and their unison into as few units as possible, and units without active lane
+are skipped in process(). For example, 4 notes with 4 unison fill a single unit.
+*/
+void DSPCORE_NAME::pickRestingNotes(size_t nUnison)
+{
+  if (noteIndices.size() >= nUnison) return;
+
+  const size_t nActiveUnit = (nVoice + 15) / 16;
+  for (size_t idx = 0; idx < nActiveUnit; ++idx) {
+    unitOrder[idx] = idx;
+    unitLoad[idx] = 0;
+  }
+  for (size_t index = 0; index < nVoice; ++index) {
+    if (notes[index].state != NoteState::rest) ++unitLoad[notes[index].arrayIndex];
+  }
+
+  std::sort(
+    unitOrder.begin(), unitOrder.begin() + nActiveUnit, [&](size_t lhs, size_t rhs) {
+      if (unitLoad[lhs] != unitLoad[rhs]) return unitLoad[lhs] > unitLoad[rhs];
+      return lhs < rhs;
+    });
+
+  for (size_t idx = 0; idx < nActiveUnit; ++idx) {
+    const size_t first = 16 * unitOrder[idx];
+    const size_t last = std::min<size_t>(first + 16, nVoice);
+    for (size_t index = first; index < last; ++index) {
+      if (notes[index].state != NoteState::rest) continue;
+      noteIndices.push_back(index);
+      if (noteIndices.size() >= nUnison) return;
+    }
+  }
+}
+
 void DSPCORE_NAME::sortVoiceIndicesByGain()
 {
   voiceIndices.resize(nVoice);
@@ -384,6 +509,36 @@ void DSPCORE_NAME::sortVoiceIndicesByGain()
   });
 }
 
+/*
+Fades out the quietest notes until the number of sounding notes fits in nVoice.
+
+All notes are searched, not only [0, nVoice). Notes above nVoice which are kept keep
+their lanes until they are released. New notes are only placed in [0, nVoice), so the
+units above become inactive and are skipped in process() after that.
+*/
+void DSPCORE_NAME::fadeOutExcessNotes()
+{
+  size_t nSounding = 0;
+  for (auto &note : notes) {
+    if (note.state == NoteState::active) ++nSounding;
+  }
+
+  for (; nSounding > nVoice; --nSounding) {
+    size_t target = notes.size();
+    for (size_t idx = 0; idx < notes.size(); ++idx) {
+      auto &note = notes[idx];
+      if (note.state != NoteState::active) continue;
+      if (target >= notes.size()) {
+        target = idx;
+      } else if (
+        !note.isAttacking(units) && note.getGain(units) < notes[target].getGain(units)) {
+        target = idx;
+      }
+    }
+    notes[target].release(units, governorFadeTime);
+  }
+}
+
 void DSPCORE_NAME::terminateNotes(size_t nNote)
 {
   if (param.value[ParameterID::voicePool]->getInt()) {
@@ -399,30 +554,43 @@ void DSPCORE_NAME::noteOn(int32_t identifier, int16_t pitch, float tuning, float
 {
   using ID = ParameterID::ID;
 
-  const size_t nUnison = 1 + param.value[ID::nUnison]->getInt();
+  // CPU governor halves unison for each level.
+  const auto governorLevel = param.value[ID::cpuGovernorLevel]->getInt();
+  const size_t nUnison
+    = std::max<size_t>((1 + param.value[ID::nUnison]->getInt()) >> governorLevel, 1);
 
   noteIndices.resize(0);
 
-  // Pick up note from resting one.
+  // Reuse note of same ID. This happens when a key held by pedal is struck again.
   for (size_t index = 0; index < nVoice; ++index) {
-    if (notes[index].id == identifier) noteIndices.push_back(index);
-    if (notes[index].state == NoteState::rest) noteIndices.push_back(index);
     if (noteIndices.size() >= nUnison) break;
+    if (notes[index].id == identifier && notes[index].state != NoteState::rest)
+      noteIndices.push_back(index);
   }
 
+  pickRestingNotes(nUnison);
+
   // If there aren't enought resting note, pick up from most quiet one.
   if (noteIndices.size() < nUnison) {
     sortVoiceIndicesByGain();
     for (auto &index : voiceIndices) {
+      if (notes[index].state == NoteState::rest) continue;
+      if (notes[index].id == identifier) continue;
       fillTransitionBuffer(index);
       noteIndices.push_back(index);
       if (noteIndices.size() >= nUnison) break;
     }
   }
 
+  const int32_t interpType = param.value[ID::oscInterpolation]->getInt();
+  const int32_t unisonInterpType = param.value[ID::unisonReduceInterpolation]->getInt()
+    ? std::max<int32_t>(interpType - 1, interpNearestRow)
+    : interpType;
+
   if (nUnison <= 1) {
     notes[noteIndices[0]].noteOn(
-      identifier, float(pitch) + tuning, velocity, 0.5f, 0.0f, info, units, param);
+      identifier, float(pitch) + tuning, velocity, 0.5f, 0.0f, interpType, info, units,
+      param);
     terminateNotes(nUnison);
     return;
   }
@@ -533,7 +701,7 @@ void DSPCORE_NAME::noteOn(int32_t identifier, int16_t pitch, float tuning, float
     auto phase = unisonPhase * unison / float(nUnison);
     notes[noteIndices[unison]].noteOn(
       identifier, notePitch, distGain(info.rng) * velocity, unisonPan[unison], phase,
-      info, units, param);
+      unison < nFullQualityUnison ? interpType : unisonInterpType, info, units, param);
   }
 
   terminateNotes(nUnison);
@@ -541,6 +709,9 @@ void DSPCORE_NAME::noteOn(int32_t identifier, int16_t pitch, float tuning, float
 
 void DSPCORE_NAME::fillTransitionBuffer(size_t noteIndex)
 {
+  const auto &wavetable = tableWorker.get();
+  if (wavetable == nullptr) return;
+
   isTransitioning = true;
 
   // Beware the negative overflow. trStop is size_t.
@@ -563,7 +734,7 @@ void DSPCORE_NAME::fillTransitionBuffer(size_t noteIndex)
       break;
     }
 
-    float oscOut = trOsc.process(pitch, wavetable.table);
+    float oscOut = trOsc.process(pitch, wavetable->table);
     auto idx = (trIndex + bufIdx) % transitionBuffer.size();
     auto interp = 1.0f - float(bufIdx) / transitionBuffer.size();
 
@@ -578,12 +749,37 @@ void DSPCORE_NAME::noteOff(int32_t noteId)
     if (notes[i].id == noteId) notes[i].release(units);
 }
 
+void DSPCORE_NAME::setNoteExpression(int32_t noteId, NoteExpression expression)
+{
+  // Notes which are not yet started in this cycle.
+  for (auto &nt : midiNotes) {
+    if (nt.isNoteOn && nt.id == noteId) nt.expression = expression;
+  }
+  applyNoteExpression(noteId, expression, false);
+}
+
+void DSPCORE_NAME::applyNoteExpression(
+  int32_t noteId, const NoteExpression &expression, bool reset)
+{
+  for (auto &note : notes) {
+    if (note.id == noteId && note.state != NoteState::rest)
+      note.setExpression(units, expression, reset);
+  }
+}
+
 void DSPCORE_NAME::refreshTable()
 {
   using ID = ParameterID::ID;
 
-  reset();
+  // Table is deterministic. Skip when it's already made from the same parameters, as
+  // refresh is requested several times on restoring a session.
+  auto &value = param.value;
+  auto key = StateSnapshot::hash(value, ID::overtoneGain0, ID::lfoWavetable0 - 1);
+  key = StateSnapshot::hash(value, ID::tableBaseFrequency, ID::uniformPhaseProfile, key);
+  key = StateSnapshot::hashBytes(sampleRate, key);
+  if (key == tableKey) return;
 
+  auto &req = tableRequest;
   const float tableBaseFreq = param.value[ID::tableBaseFrequency]->getFloat();
   const float pitchMultiplier = param.value[ID::overtonePitchMultiply]->getFloat();
   const float pitchModulo = param.value[ID::overtonePitchModulo]->getFloat();
@@ -591,24 +787,32 @@ void DSPCORE_NAME::refreshTable()
   const float widthMul = param.value[ID::overtoneWidthMultiply]->getFloat();
 
   for (size_t idx = 0; idx < nOvertone; ++idx) {
-    otFrequency[idx] = (pitchMultiplier * idx + 1.0f) * tableBaseFreq
+    req.frequency[idx] = (pitchMultiplier * idx + 1.0f) * tableBaseFreq
       * param.value[ID::overtonePitch0 + idx]->getFloat();
     if (pitchModulo != 0)
-      otFrequency[idx]
-        = fmodf(otFrequency[idx], notePitchToFrequency(pitchModulo, 12.0f, 440.0f));
-    otGain[idx] = powf(param.value[ID::overtoneGain0 + idx]->getFloat(), gainPow);
-    otBandWidth[idx] = widthMul * param.value[ID::overtoneWidth0 + idx]->getFloat();
-    otPhase[idx] = param.value[ID::overtonePhase0 + idx]->getFloat();
+      req.frequency[idx]
+        = fmodf(req.frequency[idx], notePitchToFrequency(pitchModulo, 12.0f, 440.0f));
+    req.gain[idx] = powf(param.value[ID::overtoneGain0 + idx]->getFloat(), gainPow);
+    req.bandWidth[idx] = widthMul * param.value[ID::overtoneWidth0 + idx]->getFloat();
+    req.phase[idx] = param.value[ID::overtonePhase0 + idx]->getFloat();
   }
 
-  wavetable.padsynth(
-    sampleRate, tableBaseFreq, otFrequency, otGain, otPhase, otBandWidth,
-    param.value[ID::padSynthSeed]->getInt(), param.value[ID::spectrumExpand]->getFloat(),
-    int32_t(param.value[ID::spectrumShift]->getInt()) - spectrumSize,
-    param.value[ID::profileComb]->getInt() + 1, param.value[ID::profileShape]->getFloat(),
-    param.value[ID::overtonePitchRandom]->getInt(),
-    param.value[ID::spectrumInvert]->getInt(),
-    param.value[ID::uniformPhaseProfile]->getInt());
+  req.key = key;
+  req.sampleRate = sampleRate;
+  req.tableBaseFreq = tableBaseFreq;
+  req.seed = param.value[ID::padSynthSeed]->getInt();
+  req.expand = param.value[ID::spectrumExpand]->getFloat();
+  req.shift = int32_t(param.value[ID::spectrumShift]->getInt()) - spectrumSize;
+  req.profileSkip = param.value[ID::profileComb]->getInt() + 1;
+  req.profileShape = param.value[ID::profileShape]->getFloat();
+  req.randomPitch = param.value[ID::overtonePitchRandom]->getInt();
+  req.invertSpectrum = param.value[ID::spectrumInvert]->getInt();
+  req.uniformPhaseProfile = param.value[ID::uniformPhaseProfile]->getInt();
+
+  // Table is built on `tableWorker` thread, and notes keep playing the previous table
+  // until it's done. The worker may be holding its lock, then retry on next cycle.
+  isTableRequestPending = !tableWorker.request(req);
+  if (!isTableRequestPending) tableKey = key;
 }
 
 void DSPCORE_NAME::refreshLfo()
@@ -19,6 +19,9 @@
 
 #include "../../common/dsp/constants.hpp"
 #include "../../common/dsp/smoother.hpp"
+#include "../../common/midi.hpp"
+#include "../../common/snapshot.hpp"
+#include "../../common/tableworker.hpp"
 #include "../parameter.hpp"
 #include "envelope.hpp"
 #include "noise.hpp"
@@ -28,14 +31,19 @@
 #include "../../lib/vcl/vectormath_exp.h"
 
 #include <array>
+#include <atomic>
 #include <cmath>
 #include <memory>
 #include <random>
+#include <string>
 
 using namespace SomeDSP;
 
 constexpr size_t nUnit = 8;
 
+using SharedTable = SharedWavetable<tableSize, nOvertone>;
+using TableRequest = WavetableRequest<tableSize, nOvertone>;
+
 enum class NoteState { active, release, rest };
 
 struct NoteProcessInfo {
@@ -75,6 +83,9 @@ struct NoteProcessInfo {
     ExpADSREnvelope16 gainEnvelope;                                                      \
     LinearADSREnvelope16 pitchEnvelope;                                                  \
     LinearADSREnvelope16 lowpassEnvelope;                                                \
+    ExpSmoother16 noteBend;                                                              \
+    ExpSmoother16 notePressure;                                                          \
+    ExpSmoother16 noteTimbre;                                                            \
                                                                                          \
     Vec16f notePitch = 0;                                                                \
     Vec16f pitch = 0;                                                                    \
@@ -87,11 +98,16 @@ struct NoteProcessInfo {
     Vec16f velocity = 0;                                                                 \
                                                                                          \
     bool isActive = false;                                                               \
+    bool isNoteStarted = true;                                                           \
                                                                                          \
-    void setParameters(float sampleRate, NoteProcessInfo &info, GlobalParameter &param); \
+    void setParameters(                                                                  \
+      float sampleRate,                                                                  \
+      NoteProcessInfo &info,                                                             \
+      GlobalParameter &param,                                                            \
+      bool isEnvelopeChanged);                                                           \
     std::array<float, 2> process(                                                        \
       float sampleRate,                                                                  \
-      Wavetable<tableSize, nOvertone> &wavetable,                                        \
+      const Wavetable<tableSize, nOvertone> &wavetable,                                  \
       LfoWavetable<lfoTableSize> &lfoWavetable,                                          \
       NoteProcessInfo &info);                                                            \
     void reset();                                                                        \
@@ -120,13 +136,19 @@ PROCESSING_UNIT_CLASS(SSE2)
       float velocity,                                                                    \
       float pan,                                                                         \
       float phase,                                                                       \
+      int32_t interpType,                                                                \
       NoteProcessInfo &info,                                                             \
       std::array<ProcessingUnit_##INSTRSET, nUnit> &units,                               \
       GlobalParameter &param);                                                           \
     void release(std::array<ProcessingUnit_##INSTRSET, nUnit> &units);                   \
     void release(std::array<ProcessingUnit_##INSTRSET, nUnit> &units, float seconds);    \
+    void setExpression(                                                                  \
+      std::array<ProcessingUnit_##INSTRSET, nUnit> &units,                               \
+      const NoteExpression &expression,                                                  \
+      bool reset);                                                                       \
     void rest();                                                                         \
     bool isAttacking(std::array<ProcessingUnit_##INSTRSET, nUnit> &units);               \
+    bool isTerminated(std::array<ProcessingUnit_##INSTRSET, nUnit> &units);              \
     float getGain(std::array<ProcessingUnit_##INSTRSET, nUnit> &units);                  \
   };
 
@@ -142,6 +164,10 @@ public:
   static const size_t maxVoice = 128;
   GlobalParameter param;
 
+  // Set by `request*Refresh()`, and taken by `setParameters()`.
+  std::atomic<bool> isTableRefreshRequested{false};
+  std::atomic<bool> isLfoRefreshRequested{false};
+
   virtual void setup(double sampleRate) = 0;
   virtual void reset() = 0;   // Stop sounds.
   virtual void startup() = 0; // Reset phase, random seed etc.
@@ -149,9 +175,18 @@ public:
   virtual void process(const size_t length, float *out0, float *out1) = 0;
   virtual void noteOn(int32_t noteId, int16_t pitch, float tuning, float velocity) = 0;
   virtual void noteOff(int32_t noteId) = 0;
+  virtual void setNoteExpression(int32_t noteId, NoteExpression expression) = 0;
   virtual void refreshTable() = 0;
   virtual void refreshLfo() = 0;
 
+  // Empty string disables on-disk table cache.
+  virtual void setTableCacheDirectory(const std::string &directory) = 0;
+
+  // Host thread. Defers the refresh to next `setParameters()` on audio thread. Wavetable
+  // is then built on the table worker, so host thread doesn't wait for it.
+  void requestTableRefresh() { isTableRefreshRequested.store(true); }
+  void requestLfoRefresh() { isLfoRefreshRequested.store(true); }
+
   struct MidiNote {
     bool isNoteOn;
     uint32_t frame;
@@ -159,6 +194,7 @@ public:
     int16_t pitch;
     float tuning;
     float velocity;
+    NoteExpression expression;
   };
 
   std::vector<MidiNote> midiNotes;
@@ -187,7 +223,12 @@ public:
     void noteOn(int32_t noteId, int16_t pitch, float tuning, float velocity) override;   \
     void fillTransitionBuffer(size_t noteIndex);                                         \
     void noteOff(int32_t noteId) override;                                               \
+    void setNoteExpression(int32_t noteId, NoteExpression expression) override;          \
     void refreshTable() override;                                                        \
+    void setTableCacheDirectory(const std::string &directory) override                   \
+    {                                                                                    \
+      tableWorker.setCacheDirectory(directory);                                          \
+    }                                                                                    \
     void refreshLfo() override;                                                          \
                                                                                          \
     void pushMidiNote(                                                                   \
@@ -216,31 +257,40 @@ public:
               return nt.frame == frame;                                                  \
             });                                                                          \
         if (it == std::end(midiNotes)) return;                                           \
-        if (it->isNoteOn)                                                                \
+        if (it->isNoteOn) {                                                              \
           noteOn(it->id, it->pitch, it->tuning, it->velocity);                           \
-        else                                                                             \
+          applyNoteExpression(it->id, it->expression, true);                             \
+        } else {                                                                         \
           noteOff(it->id);                                                               \
+        }                                                                                \
         midiNotes.erase(it);                                                             \
       }                                                                                  \
     }                                                                                    \
                                                                                          \
   private:                                                                               \
+    void applyNoteExpression(                                                            \
+      int32_t noteId, const NoteExpression &expression, bool reset);                     \
+    void pickRestingNotes(size_t nUnison);                                               \
+    void restTerminatedNotes();                                                          \
     void sortVoiceIndicesByGain();                                                       \
+    void fadeOutExcessNotes();                                                           \
     void terminateNotes(size_t nNote);                                                   \
                                                                                          \
     float sampleRate = 44100.0f;                                                         \
                                                                                          \
-    std::array<float, nOvertone> otFrequency{};                                          \
-    std::array<float, nOvertone> otGain{};                                               \
-    std::array<float, nOvertone> otPhase{};                                              \
-    std::array<float, nOvertone> otBandWidth{};                                          \
     bool prepareRefresh = true;                                                          \
     bool isTableRefeshed = false;                                                        \
     bool isLFORefreshed = false;                                                         \
+    uint64_t tableKey = 0;                                                               \
+    bool isTableRequestPending = false;                                                  \
                                                                                          \
-    Wavetable<tableSize, nOvertone> wavetable;                                           \
+    TableRequest tableRequest{std::make_shared<PadSynth<tableSize, nOvertone>>()};       \
+    TableWorker<SharedTable, TableRequest> tableWorker{                                  \
+      std::make_unique<SharedTable>(), TableRequest()};                                  \
     LfoWavetable<lfoTableSize> lfoWavetable;                                             \
     std::array<ProcessingUnit_##INSTRSET, nUnit> units;                                  \
+    std::array<size_t, nUnit> unitOrder{};                                               \
+    std::array<size_t, nUnit> unitLoad{};                                                \
                                                                                          \
     size_t nVoice = 32;                                                                  \
     int32_t panCounter = 0;                                                              \
@@ -257,6 +307,7 @@ public:
     size_t trIndex = 0;                                                                  \
     size_t trStop = 0;                                                                   \
     TableOsc<tableSize> trOsc;                                                           \
+    std::array<float, 3> envelopePitchInfo{};                                            \
   };
 
 DSPCORE_CLASS(AVX512)
@@ -63,6 +63,14 @@ public:
     state.insert(index, stateAttack);
     value.insert(index, float(1));
     declickIn.insert(index, 0);
+    fixedRel.insert(index, 0);
+  }
+
+  // `sus` is `LinearSmoother`, so it must be pushed on every cycle. Call this instead of
+  // `set()` when the other parameters are not changed.
+  void setSustain(float sustainLevel)
+  {
+    sus.push(std::max<float>(float(0.0), std::min<float>(sustainLevel, float(1.0))));
   }
 
   void set(
@@ -72,15 +80,18 @@ public:
     float releaseTime,
     Vec16f noteFreq)
   {
-    sus.push(std::max<float>(float(0.0), std::min<float>(sustainLevel, float(1.0))));
+    setSustain(sustainLevel);
     atk = secondToMultiplier(adaptTime(attackTime, noteFreq));
     dec = secondToMultiplier(decayTime);
-    rel = secondToMultiplier(adaptTime(releaseTime, noteFreq));
+    rel = select(
+      fixedRel > 0, fixedRel, secondToMultiplier(adaptTime(releaseTime, noteFreq)));
   }
 
+  // Release time set by this method is kept until next `reset(index)`.
   void setRelease(int index, float seconds)
   {
-    rel.insert(index, secondToMultiplier(seconds));
+    fixedRel.insert(index, secondToMultiplier(seconds));
+    rel.insert(index, fixedRel[index]);
   }
 
   void release(int index)
@@ -147,6 +158,7 @@ protected:
   Vec16f atk = 1;
   Vec16f dec = 1;
   Vec16f rel = 1;
+  Vec16f fixedRel = 0; // 0 means not fixed.
   Vec16i state = stateTerminated;
   Vec16f value = 0;
   Vec16f out = 0;
@@ -188,6 +200,13 @@ public:
     set(attackTime, decayTime, sustainLevel, releaseTime, noteFreq);
   }
 
+  // `sus` is `LinearSmoother`, so it must be pushed on every cycle. Call this instead of
+  // `set()` when the other parameters are not changed.
+  void setSustain(float sustainLevel)
+  {
+    sus.push(std::max<float>(float(0.0), std::min<float>(sustainLevel, float(1.0))));
+  }
+
   void set(
     float attackTime,
     float decayTime,
@@ -195,7 +214,7 @@ public:
     float releaseTime,
     Vec16f noteFreq)
   {
-    sus.push(std::max<float>(float(0.0), std::min<float>(sustainLevel, float(1.0))));
+    setSustain(sustainLevel);
     atk = secondToDelta(adaptTime(attackTime, noteFreq));
     dec = secondToDelta(adaptTime(decayTime, noteFreq));
     rel = secondToDelta(adaptTime(releaseTime, noteFreq));
@@ -23,18 +23,36 @@
 
 #include "../../common/dsp/constants.hpp"
 #include "../../common/dsp/somemath.hpp"
+#include "../../common/tablecache.hpp"
+#include "../../common/tablefile.hpp"
 
 #include <algorithm>
 #include <array>
+#include <complex>
 #include <cstring>
 #include <deque>
+#include <memory>
+#include <mutex>
 #include <random>
+#include <string>
+#include <vector>
 
 namespace SomeDSP {
 
 constexpr size_t nTable = 136; // midi note nubmer 136 ~= 21096 Hz.
-constexpr size_t nTablePadded = nTable + 4;
-constexpr size_t notePitchUpperBound = nTable + 1;
+constexpr size_t nOctave = 13;  // Rows are band limited at midi note 0, 12, ..., 144.
+constexpr size_t nTablePadded = nOctave + 5;
+
+// Maps to row `nOctave + 1`, which is silence. Bicubic reads 3 more rows above it.
+constexpr size_t notePitchUpperBound = 12 * (nOctave - 1);
+
+// Converts note pitch to fractional row index of `Wavetable::table`. Offset is 2, so
+// `floor(row)` and all rows above are band limited at or above `notePitch`.
+inline float notePitchToRow(float notePitch) { return 2.0f + notePitch / 12.0f; }
+inline Vec16f notePitchToRow(Vec16f notePitch)
+{
+  return float(2) + notePitch * float(1.0 / 12.0);
+}
 
 // Range of t is in [0, 1]. Interpoltes between y1 and y2.
 inline float cubicInterp(float y0, float y1, float y2, float y3, float t)
@@ -58,6 +76,26 @@ inline Vec16f cubicInterp(Vec16f y0, Vec16f y1, Vec16f y2, Vec16f y3, Vec16f t)
   return c3 * t * t2 - (c2 + c3) * t2 + c1 * t + y1;
 }
 
+// Range of t is in [0, 1]. Interpoltes between y0 and y1, using y2 and y3 as the points
+// after them. Cubic polynomial through the 4 points in Newton form.
+inline float cubicInterpForward(float y0, float y1, float y2, float y3, float t)
+{
+  auto d1 = y1 - y0;
+  auto d2 = (y2 - 2.0f * y1 + y0) * 0.5f;
+  auto d3 = (y3 - 3.0f * (y2 - y1) - y0) * float(1.0 / 6.0);
+  return y0 + t * (d1 + (t - 1.0f) * (d2 + (t - 2.0f) * d3));
+}
+
+// Range of t is in [0, 1]. Interpoltes between y0 and y1, using y2 and y3 as the points
+// after them. Cubic polynomial through the 4 points in Newton form.
+inline Vec16f cubicInterpForward(Vec16f y0, Vec16f y1, Vec16f y2, Vec16f y3, Vec16f t)
+{
+  auto d1 = y1 - y0;
+  auto d2 = (y2 - float(2) * y1 + y0) * float(0.5);
+  auto d3 = (y3 - float(3) * (y2 - y1) - y0) * float(1.0 / 6.0);
+  return y0 + t * (d1 + (t - float(1)) * (d2 + (t - float(2)) * d3));
+}
+
 /*
 table is 2d array which has extra padding for interpolation.
 
@@ -70,12 +108,18 @@ table is 2d array which has extra padding for interpolation.
 @   0  0  0  0  0  0  0
 @   0  0  0  0  0  0  0
 @   0  0  0  0  0  0  0
+@   0  0  0  0  0  0  0
 
 '@' in figure above represents padded array. Index is table[column][row].
 - Padded first column has last element of original table.
 - Padded last column has first element of original table.
 - Padded first row is copy of first row of original table.
-- Padded last 3 row is silence.
+- Padded last 4 row is silence.
+
+Rows are octave spaced. Row `n` is band limited at midi note `12 * (n - 1)`, so only
+`nOctave` inverse FFT are required to refresh the table. Oscillators map note pitch to
+row by `notePitchToRow()`, and interpolate between the 2 octaves above the pitch. Lower
+row would alias, so bicubic reads 2 more rows above instead of 1 below and 1 above.
 */
 template<size_t tableSize, size_t nPeak> struct Wavetable {
   static constexpr size_t spectrumSize = tableSize / 2 + 1;
@@ -83,8 +127,8 @@ template<size_t tableSize, size_t nPeak> struct Wavetable {
   fftwf_complex *spectrum;
   fftwf_complex *bandLimited;
   fftwf_complex *tmpSpec;
-  std::array<float *, nTablePadded> table;
-  std::array<fftwf_plan, nTablePadded> plan;
+  float *data; // All rows in one block. Size is `nTablePadded * paddedSize`.
+  std::array<float *, nTablePadded> table; // Pointers to rows in `data`.
   std::array<float, nTablePadded> frequency; // Must be sorted by ascending order.
   bool isRefreshing = true;
   float tableBaseFreq = 20.0f;
@@ -95,63 +139,103 @@ template<size_t tableSize, size_t nPeak> struct Wavetable {
     bandLimited = (fftwf_complex *)fftwf_malloc(sizeof(fftwf_complex) * spectrumSize);
     tmpSpec = (fftwf_complex *)fftwf_malloc(sizeof(fftwf_complex) * spectrumSize);
 
+    data = (float *)fftwf_malloc(sizeof(float) * nTablePadded * paddedSize);
     for (size_t idx = 0; idx < nTablePadded; ++idx) {
-      table[idx] = (float *)fftwf_malloc(sizeof(float) * paddedSize);
+      table[idx] = data + idx * paddedSize;
       table[idx][0] = 0;
       table[idx][paddedSize - 1] = 0;
 
-      plan[idx]
-        = fftwf_plan_dft_c2r_1d(tableSize, bandLimited, table[idx] + 1, FFTW_ESTIMATE);
-
-      // TODO: Experiment with different frequency.
-      frequency[idx] = 440.0f * powf(2.0f, (idx - 69.0f) / 12.0f);
+      frequency[idx] = 440.0f * powf(2.0f, (12.0f * (idx - 1.0f) - 69.0f) / 12.0f);
     }
 
-    // Last 3 tables are slince.
-    for (size_t idx = nTablePadded - 3; idx < nTablePadded; ++idx) {
+    // Last 4 tables are slince.
+    for (size_t idx = nTablePadded - 4; idx < nTablePadded; ++idx) {
       for (size_t i = 0; i < paddedSize; ++i) table[idx][i] = 0;
     }
   }
 
+  Wavetable(const Wavetable &) = delete;
+  Wavetable &operator=(const Wavetable &) = delete;
+
   ~Wavetable()
   {
-    for (auto &pln : plan) fftwf_destroy_plan(pln);
-    for (auto &tbl : table) fftwf_free(tbl);
+    fftwf_free(data);
     fftwf_free(tmpSpec);
     fftwf_free(bandLimited);
     fftwf_free(spectrum);
   }
 
-  inline float profile(float fi, float bwi, float shape)
+  // Layout of `TableFile`. `tableBaseFreq` followed by all the padded tables.
+  std::vector<TableFile::Chunk> getChunks() const
   {
-    if (bwi < 1e-5) bwi = 1e-5;
-    auto x = fi / bwi;
-    return powf(expf(-x * x) / bwi, shape);
+    return {{&tableBaseFreq, 1}, {data, nTablePadded * paddedSize}};
+  }
+
+  bool load(const TableFile &file)
+  {
+    if (file.size() != 1 + nTablePadded * paddedSize) return false;
+
+    const float *src = file.data();
+    tableBaseFreq = src[0];
+    std::memcpy(data, src + 1, sizeof(float) * nTablePadded * paddedSize);
+    isRefreshing = false;
+    return true;
   }
 
-  void refreshTable(float sampleRate)
+  // Plans only live in this method, so destructor can run on any thread. FFTW planner
+  // is not thread safe, so creation and destruction hold `fftwPlannerMutex()`.
+  void execute(size_t idx)
+  {
+    fftwf_plan plan;
+    {
+      std::lock_guard<std::mutex> lock(fftwPlannerMutex());
+      plan = fftwf_plan_dft_c2r_1d(tableSize, bandLimited, table[idx] + 1, FFTW_ESTIMATE);
+    }
+    fftwf_execute(plan);
+    std::lock_guard<std::mutex> lock(fftwPlannerMutex());
+    fftwf_destroy_plan(plan);
+  }
+
+  // Rows whose band limit is under `lowestBin` are copied from `prev`, which was
+  // normalized by `prevMax`. Returns the gain used for normalization.
+  float refreshTable(
+    size_t lowestBin = 0, const Wavetable *prev = nullptr, float prevMax = 1.0f)
   {
     isRefreshing = true;
 
+    auto copyRow = [&](size_t idx) {
+      for (size_t i = 0; i < paddedSize; ++i)
+        table[idx][i] = prevMax * prev->table[idx][i];
+    };
+
     // table[0] and table[1] has full spectrum.
-    bandLimited[0][0] = 0;
-    bandLimited[0][1] = 0;
-    std::memcpy(
-      bandLimited + 1, spectrum + 1, sizeof(fftwf_complex) * (spectrumSize - 1));
-    fftwf_execute(plan[0]);
+    if (prev != nullptr && spectrumSize <= lowestBin) {
+      copyRow(0);
+    } else {
+      bandLimited[0][0] = 0;
+      bandLimited[0][1] = 0;
+      std::memcpy(
+        bandLimited + 1, spectrum + 1, sizeof(fftwf_complex) * (spectrumSize - 1));
+      execute(0);
+    }
     std::memcpy(table[1], table[0], sizeof(float) * paddedSize);
 
-    for (size_t idx = 2; idx <= nTable; ++idx) {
+    for (size_t idx = 2; idx <= nOctave; ++idx) {
       size_t bandIdx = size_t(spectrumSize * tableBaseFreq / frequency[idx]);
       bandIdx = std::clamp<size_t>(bandIdx, 1, spectrumSize);
 
+      if (prev != nullptr && bandIdx <= lowestBin) {
+        copyRow(idx);
+        continue;
+      }
+
       bandLimited[0][0] = 0;
       bandLimited[0][1] = 0;
       std::memcpy(bandLimited + 1, spectrum + 1, sizeof(fftwf_complex) * (bandIdx - 1));
       std::memset(
         bandLimited + bandIdx, 0, sizeof(fftwf_complex) * (spectrumSize - bandIdx));
 
-      fftwf_execute(plan[idx]);
+      execute(idx);
     }
 
     // Fill padded elements.
@@ -174,59 +258,19 @@ template<size_t tableSize, size_t nPeak> struct Wavetable {
     }
 
     isRefreshing = false;
+    return max != 0.0f ? max : 1.0f;
   }
 
   inline float sign(float x) { return (0 < x) - (x < 0); }
 
-  void padsynth(
-    float sampleRate,
-    float tableBaseFreq,
-    std::array<float, nPeak> &frequency,
-    std::array<float, nPeak> &gain,
-    std::array<float, nPeak> &phase,
-    std::array<float, nPeak> &bandWidth,
-    uint32_t seed,
-    float expand,
-    int32_t shift,
-    uint32_t profileSkip,
-    uint32_t profileShape,
-    bool randomPitch,
+  // Applies spectral modifiers to the sum of peak profiles.
+  void shapeSpectrum(
+    const std::vector<std::complex<float>> &peakSum,
     bool invertSpectrum,
-    bool uniformPhaseProfile)
+    float expand,
+    int32_t shift)
   {
-    this->tableBaseFreq = tableBaseFreq;
-
-    for (int32_t bin = 0; bin < spectrumSize; ++bin) {
-      spectrum[bin][0] = 0;
-      spectrum[bin][1] = 0;
-    }
-
-    std::mt19937 rng(seed);
-    std::uniform_real_distribution<float> distFreq(100.0f, 8000.0f);
-    for (int32_t peak = 0; peak < nPeak; ++peak) {
-      float freq = randomPitch ? distFreq(rng) : frequency[peak];
-      float bandHz = (powf(2.0f, bandWidth[peak] / 1200.0f) - 1.0f) * freq;
-      float bandIdx = bandHz / (2.0f * sampleRate);
-
-      float sigma = sqrtf(bandIdx * bandIdx / float(twopi));
-      int32_t profileHalf = std::max<int32_t>(1, int32_t(spectrumSize * 5.0f * sigma));
-
-      float freqIdx = freq * 2.0f / sampleRate;
-
-      int32_t center = int32_t(freqIdx * spectrumSize);
-      int32_t start = std::max<int32_t>(center - profileHalf, 0);
-      int32_t end = std::min<int32_t>(center + profileHalf, spectrumSize);
-
-      std::uniform_real_distribution<float> distPhase(0.0f, phase[peak]);
-      auto phase = distPhase(rng);
-      for (int32_t bin = start; bin < end; bin += profileSkip) {
-        auto radius = gain[peak]
-          * profile(bin / float(spectrumSize) - freqIdx, bandIdx, profileShape);
-        if (!uniformPhaseProfile) phase = distPhase(rng);
-        spectrum[bin][0] += radius * cosf(phase);
-        spectrum[bin][1] += radius * sinf(phase);
-      }
-    }
+    std::memcpy(spectrum, peakSum.data(), sizeof(fftwf_complex) * spectrumSize);
 
     if (invertSpectrum) {
       float reMax = 0;
@@ -274,11 +318,204 @@ template<size_t tableSize, size_t nPeak> struct Wavetable {
     // Remove DC offset.
     spectrum[0][0] = 0.0f;
     spectrum[0][1] = 0.0f;
+  }
+};
+
+// Built table is immutable, and shared between plugin instances by `TableCache`.
+template<size_t tableSize, size_t nPeak>
+using SharedWavetable = std::shared_ptr<const Wavetable<tableSize, nPeak>>;
+
+template<size_t tableSize, size_t nPeak> class PadSynth;
+
+// Inputs of `PadSynth::build()`. `build()` is called on `TableWorker` thread.
+template<size_t tableSize, size_t nPeak> struct WavetableRequest {
+  uint64_t key = 0; // Hash of other members. Same key returns the same cached table.
+  float sampleRate = 44100.0f;
+  float tableBaseFreq = 20.0f;
+  std::array<float, nPeak> frequency{};
+  std::array<float, nPeak> gain{};
+  std::array<float, nPeak> phase{};
+  std::array<float, nPeak> bandWidth{};
+  uint32_t seed = 0;
+  float expand = 1.0f;
+  int32_t shift = 0;
+  uint32_t profileSkip = 1;
+  uint32_t profileShape = 1;
+  bool randomPitch = false;
+  bool invertSpectrum = false;
+  bool uniformPhaseProfile = false;
+
+  // State of incremental update. Copies of a request share the same `PadSynth`.
+  std::shared_ptr<PadSynth<tableSize, nPeak>> padsynth;
+
+  WavetableRequest(std::shared_ptr<PadSynth<tableSize, nPeak>> padsynth = nullptr)
+    : padsynth(padsynth)
+  {
+  }
+
+  // `cacheDirectory` is the directory of `TableFile`. Empty disables it.
+  std::unique_ptr<SharedWavetable<tableSize, nPeak>>
+  build(const std::string &cacheDirectory) const;
+};
+
+// Seed of each peak is independent from other peaks, so a peak can be recomputed alone.
+// Mixing is the finalizer of splitmix64.
+inline uint32_t peakSeed(uint32_t seed, size_t index)
+{
+  uint64_t z = (uint64_t(seed) << 32) + index + 0x9e3779b97f4a7c15;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+  return uint32_t(z ^ (z >> 31));
+}
 
-    refreshTable(sampleRate);
+/**
+PADsynth with incremental update. Only used on `TableWorker` thread.
+
+Sum of peak profiles is kept from the previous build. When a few peaks are changed, old
+contribution of those peaks is subtracted and new one is added, so `profile()` is only
+evaluated on their bins. Rows whose band limit is under the lowest changed bin are copied
+from the previous table instead of inverse FFT.
+
+Subtraction leaves float error, so the sum is rebuilt from scratch every
+`maxIncrementalUpdate` builds, or when a parameter other than peaks is changed.
+*/
+template<size_t tableSize, size_t nPeak> class PadSynth {
+public:
+  using Table = Wavetable<tableSize, nPeak>;
+  using Request = WavetableRequest<tableSize, nPeak>;
+  static constexpr int32_t spectrumSize = int32_t(Table::spectrumSize);
+  static constexpr size_t maxIncrementalUpdate = 64;
+
+  PadSynth() : peakSum(spectrumSize) {}
+
+  std::shared_ptr<Table> build(const Request &req)
+  {
+    auto wavetable = std::make_shared<Table>();
+    wavetable->tableBaseFreq = req.tableBaseFreq;
+
+    // Invert, expand and shift move bins, so changed range is unknown. Band limit of
+    // rows depends on `tableBaseFreq`.
+    size_t lowestBin = accumulate(req);
+    if (req.invertSpectrum || req.expand != 1.0f || req.shift != 0) lowestBin = 0;
+    if (
+      req.invertSpectrum != prev.invertSpectrum || req.expand != prev.expand
+      || req.shift != prev.shift || req.tableBaseFreq != prev.tableBaseFreq)
+      lowestBin = 0;
+
+    wavetable->shapeSpectrum(peakSum, req.invertSpectrum, req.expand, req.shift);
+    const float max = wavetable->refreshTable(lowestBin, prevTable.get(), prevMax);
+
+    prev = req;
+    prev.padsynth = nullptr;
+    prevTable = wavetable;
+    prevMax = max;
+    return wavetable;
   }
+
+private:
+  static float profile(float fi, float bwi, float shape)
+  {
+    if (bwi < 1e-5) bwi = 1e-5;
+    auto x = fi / bwi;
+    return powf(expf(-x * x) / bwi, shape);
+  }
+
+  static bool isSamePeak(const Request &a, const Request &b, size_t idx)
+  {
+    return a.frequency[idx] == b.frequency[idx] && a.gain[idx] == b.gain[idx]
+      && a.phase[idx] == b.phase[idx] && a.bandWidth[idx] == b.bandWidth[idx];
+  }
+
+  // Returns the lowest bin which is changed from previous build.
+  size_t accumulate(const Request &req)
+  {
+    const bool isSameShape = prevTable != nullptr && nUpdate < maxIncrementalUpdate
+      && req.sampleRate == prev.sampleRate && req.seed == prev.seed
+      && req.profileSkip == prev.profileSkip && req.profileShape == prev.profileShape
+      && req.randomPitch == prev.randomPitch
+      && req.uniformPhaseProfile == prev.uniformPhaseProfile;
+
+    std::vector<size_t> changed;
+    if (isSameShape) {
+      for (size_t idx = 0; idx < nPeak; ++idx)
+        if (!isSamePeak(req, prev, idx)) changed.push_back(idx);
+    }
+
+    // Incremental update costs 2 peaks for each changed peak.
+    if (!isSameShape || 2 * changed.size() > nPeak) {
+      std::fill(peakSum.begin(), peakSum.end(), 0);
+      for (size_t idx = 0; idx < nPeak; ++idx) addPeak(req, idx, 1.0f);
+      nUpdate = 0;
+      return 0;
+    }
+
+    size_t lowestBin = spectrumSize;
+    for (const auto &idx : changed) {
+      lowestBin = std::min(lowestBin, addPeak(prev, idx, -1.0f));
+      lowestBin = std::min(lowestBin, addPeak(req, idx, 1.0f));
+    }
+    ++nUpdate;
+    return lowestBin;
+  }
+
+  // Returns the first bin of the peak.
+  size_t addPeak(const Request &req, size_t index, float sign)
+  {
+    if (req.gain[index] == 0) return spectrumSize;
+
+    std::mt19937 rng(peakSeed(req.seed, index));
+    std::uniform_real_distribution<float> distFreq(100.0f, 8000.0f);
+    float freq = req.randomPitch ? distFreq(rng) : req.frequency[index];
+    float bandHz = (powf(2.0f, req.bandWidth[index] / 1200.0f) - 1.0f) * freq;
+    float bandIdx = bandHz / (2.0f * req.sampleRate);
+
+    float sigma = sqrtf(bandIdx * bandIdx / float(twopi));
+    int32_t profileHalf = std::max<int32_t>(1, int32_t(spectrumSize * 5.0f * sigma));
+
+    float freqIdx = freq * 2.0f / req.sampleRate;
+
+    int32_t center = int32_t(freqIdx * spectrumSize);
+    int32_t start = std::max<int32_t>(center - profileHalf, 0);
+    int32_t end = std::min<int32_t>(center + profileHalf, spectrumSize);
+    if (start >= end) return spectrumSize;
+
+    std::uniform_real_distribution<float> distPhase(0.0f, req.phase[index]);
+    auto phase = distPhase(rng);
+    const int32_t skip = std::max<int32_t>(1, int32_t(req.profileSkip));
+    for (int32_t bin = start; bin < end; bin += skip) {
+      auto radius = sign * req.gain[index]
+        * profile(bin / float(spectrumSize) - freqIdx, bandIdx, req.profileShape);
+      if (!req.uniformPhaseProfile) phase = distPhase(rng);
+      peakSum[bin] += std::complex<float>(radius * cosf(phase), radius * sinf(phase));
+    }
+    return size_t(start);
+  }
+
+  Request prev;
+  std::vector<std::complex<float>> peakSum;
+  std::shared_ptr<const Table> prevTable;
+  float prevMax = 1.0f;
+  size_t nUpdate = 0;
 };
 
+template<size_t tableSize, size_t nPeak>
+std::unique_ptr<SharedWavetable<tableSize, nPeak>>
+WavetableRequest<tableSize, nPeak>::build(const std::string &cacheDirectory) const
+{
+  using Table = Wavetable<tableSize, nPeak>;
+  auto table = TableCache<Table>::instance().get(key, [&]() {
+    const auto path = TableFile::getPath(cacheDirectory, key);
+    auto wavetable = std::make_shared<Table>();
+    if (wavetable->load(TableFile(path, key))) return wavetable;
+
+    wavetable = padsynth ? padsynth->build(*this)
+                         : PadSynth<tableSize, nPeak>().build(*this);
+    TableFile::write(path, key, wavetable->getChunks());
+    return wavetable;
+  });
+  return std::make_unique<SharedWavetable<tableSize, nPeak>>(std::move(table));
+}
+
 template<size_t tableSize> struct TableOsc {
   static constexpr size_t paddedLast = tableSize + 1;
   float phase = 1; // table index starts from 1. 0 is padded index.
@@ -294,7 +531,7 @@ template<size_t tableSize> struct TableOsc {
 
   // notePitch is fractional note number. For example, notePitch = 60.12 means 60
   // semitones and 12 cents higher from midi note number 0.
-  float process(float notePitch, std::array<float *, nTablePadded> &table)
+  float process(float notePitch, const std::array<float *, nTablePadded> &table)
   {
     phase += tick;
     if (phase > paddedLast) phase -= tableSize;
@@ -309,11 +546,11 @@ template<size_t tableSize> struct TableOsc {
     } else if (notePitch >= notePitchUpperBound) {
       return 0;
     }
-    notePitch += 1.0f;
+    float row = notePitchToRow(notePitch);
 
     // // Bilinear interpolation.
-    // auto yFrac = notePitch - floor(notePitch);
-    // size_t south = size_t(notePitch);
+    // auto yFrac = row - floor(row);
+    // size_t south = size_t(row);
     // size_t north = south + 1;
     // auto xFrac = phase - floor(phase);
     // size_t L = size_t(phase);
@@ -322,12 +559,12 @@ template<size_t tableSize> struct TableOsc {
     // auto x1 = table[north][L] + xFrac * (table[north][R] - table[north][L]);
     // return x0 + yFrac * (x1 - x0);
 
-    // Bicubic interpolation.
-    auto yFrac = notePitch - floor(notePitch);
-    size_t iy1 = size_t(notePitch);
-    size_t iy0 = iy1 - 1;
-    size_t iy2 = iy1 + 1;
-    size_t iy3 = iy1 + 2;
+    // Bicubic interpolation. Lowest row is `floor(row)`, which doesn't alias.
+    auto yFrac = row - floor(row);
+    size_t iy0 = size_t(row);
+    size_t iy1 = iy0 + 1;
+    size_t iy2 = iy0 + 2;
+    size_t iy3 = iy0 + 3;
 
     auto xFrac = phase - floor(phase);
     size_t ix1 = size_t(phase);
@@ -343,14 +580,20 @@ template<size_t tableSize> struct TableOsc {
       table[iy2][ix0], table[iy2][ix1], table[iy2][ix2], table[iy2][ix3], xFrac);
     auto y3 = cubicInterp(
       table[iy3][ix0], table[iy3][ix1], table[iy3][ix2], table[iy3][ix3], xFrac);
-    return cubicInterp(y0, y1, y2, y3, yFrac);
+    return cubicInterpForward(y0, y1, y2, y3, yFrac);
   }
 };
 
+// Interpolation between rows of `Wavetable::table`. Interpolation along phase is always
+// cubic.
+enum TableInterpType : int32_t { interpNearestRow, interpLinearRow, interpBicubic };
+
 template<size_t tableSize> struct alignas(64) TableOsc16 {
+  static constexpr size_t paddedSize = tableSize + 3;
   static constexpr size_t paddedLast = tableSize + 1;
   Vec16f phase = 1; // table index starts from 1. 0 is padded index.
   Vec16f tick = 0;
+  Vec16i interpType = interpBicubic;
 
   // Input phase is normalized in [0, 1], member phase is in [1, paddedLast].
   void setPhase(Vec16f phase) { this->phase = 1.0f + (phase - floor(phase)) * tableSize; }
@@ -372,35 +615,32 @@ template<size_t tableSize> struct alignas(64) TableOsc16 {
     tick.insert(index, tck >= tableSize ? 0 : tck);
   }
 
+  void setInterpType(int index, int32_t type) { interpType.insert(index, type); }
+
   void reset() { phase = 1; }
 
-  inline Vec16f loadTable(Vec16i ix, Vec16i iy, std::array<float *, nTablePadded> &table)
+  // `table` is `Wavetable::data`. Index of each lane is computed from the single base
+  // pointer, so VCL `lookup` compiles to gather on AVX2 and AVX512, and to scalar loads
+  // on SSE.
+  inline Vec16f loadTable(Vec16i ix, Vec16i iy, const float *table)
   {
-    return Vec16f(
-      table[iy.extract(0)][ix.extract(0)], table[iy.extract(1)][ix.extract(1)],
-      table[iy.extract(2)][ix.extract(2)], table[iy.extract(3)][ix.extract(3)],
-      table[iy.extract(4)][ix.extract(4)], table[iy.extract(5)][ix.extract(5)],
-      table[iy.extract(6)][ix.extract(6)], table[iy.extract(7)][ix.extract(7)],
-      table[iy.extract(8)][ix.extract(8)], table[iy.extract(9)][ix.extract(9)],
-      table[iy.extract(10)][ix.extract(10)], table[iy.extract(11)][ix.extract(11)],
-      table[iy.extract(12)][ix.extract(12)], table[iy.extract(13)][ix.extract(13)],
-      table[iy.extract(14)][ix.extract(14)], table[iy.extract(15)][ix.extract(15)]);
+    return lookup<int(nTablePadded * paddedSize)>(iy * int(paddedSize) + ix, table);
   }
 
   // notePitch is fractional note number. For example, notePitch = 60.12 means 60
   // semitones and 12 cents higher from midi note number 0.
-  Vec16f process(Vec16f notePitch, std::array<float *, nTablePadded> &table)
+  Vec16f process(Vec16f notePitch, const float *table)
   {
     phase += tick;
     phase = select(phase >= paddedLast, phase - tableSize, phase);
 
     notePitch = select(notePitch <= 0, 0, notePitch);
-    notePitch += float(1);
     notePitch = select(notePitch >= notePitchUpperBound, notePitchUpperBound, notePitch);
+    Vec16f row = notePitchToRow(notePitch);
 
     // Bilinear interpolation.
-    Vec16f yFrac = notePitch - floor(notePitch);
-    Vec16i iy0 = truncatei(notePitch);
+    Vec16f yFrac = row - floor(row);
+    Vec16i iy0 = truncatei(row);
     Vec16i iy1 = iy0 + 1;
 
     Vec16f xFrac = phase - floor(phase);
@@ -418,22 +658,19 @@ template<size_t tableSize> struct alignas(64) TableOsc16 {
     return y0 + yFrac * (y1 - y0);
   }
 
-  // Too slow.
-  Vec16f processCubic(Vec16f notePitch, std::array<float *, nTablePadded> &table)
+  // Bicubic, linear and nearest rows cost 16, 8 and 4 gathers. Each lane uses its own
+  // `interpType`, and a type is only computed when some lane uses it.
+  Vec16f processCubic(Vec16f notePitch, const float *table)
   {
     phase += tick;
     phase = select(phase >= paddedLast, phase - tableSize, phase);
 
     notePitch = select(notePitch <= 0, 0, notePitch);
-    notePitch += float(1);
     notePitch = select(notePitch >= notePitchUpperBound, notePitchUpperBound, notePitch);
+    Vec16f row = notePitchToRow(notePitch);
 
-    // Bicubic interpolation.
-    Vec16f yFrac = notePitch - floor(notePitch);
-    Vec16i iy1 = truncatei(notePitch);
-    Vec16i iy0 = iy1 - 1;
-    Vec16i iy2 = iy1 + 1;
-    Vec16i iy3 = iy1 + 2;
+    Vec16f yFrac = row - floor(row);
+    Vec16i iy1 = truncatei(row);
 
     Vec16f xFrac = phase - floor(phase);
     Vec16i ix1 = truncatei(phase);
@@ -441,31 +678,27 @@ template<size_t tableSize> struct alignas(64) TableOsc16 {
     Vec16i ix2 = ix1 + 1;
     Vec16i ix3 = ix1 + 2;
 
-    Vec16f table00 = loadTable(ix0, iy0, table);
-    Vec16f table01 = loadTable(ix1, iy0, table);
-    Vec16f table02 = loadTable(ix2, iy0, table);
-    Vec16f table03 = loadTable(ix3, iy0, table);
-    Vec16f y0 = cubicInterp(table00, table01, table02, table03, xFrac);
-
-    Vec16f table10 = loadTable(ix0, iy1, table);
-    Vec16f table11 = loadTable(ix1, iy1, table);
-    Vec16f table12 = loadTable(ix2, iy1, table);
-    Vec16f table13 = loadTable(ix3, iy1, table);
-    Vec16f y1 = cubicInterp(table10, table11, table12, table13, xFrac);
-
-    Vec16f table20 = loadTable(ix0, iy2, table);
-    Vec16f table21 = loadTable(ix1, iy2, table);
-    Vec16f table22 = loadTable(ix2, iy2, table);
-    Vec16f table23 = loadTable(ix3, iy2, table);
-    Vec16f y2 = cubicInterp(table20, table21, table22, table23, xFrac);
-
-    Vec16f table30 = loadTable(ix0, iy3, table);
-    Vec16f table31 = loadTable(ix1, iy3, table);
-    Vec16f table32 = loadTable(ix2, iy3, table);
-    Vec16f table33 = loadTable(ix3, iy3, table);
-    Vec16f y3 = cubicInterp(table30, table31, table32, table33, xFrac);
-
-    return cubicInterp(y0, y1, y2, y3, yFrac);
+    auto interpRow = [&](Vec16i iy) {
+      return cubicInterp(
+        loadTable(ix0, iy, table), loadTable(ix1, iy, table), loadTable(ix2, iy, table),
+        loadTable(ix3, iy, table), xFrac);
+    };
+
+    // Nearest reads the lower row, which is the brightest row that doesn't alias.
+    Vec16ib isNearest(interpType == interpNearestRow);
+    if (horizontal_and(isNearest)) return interpRow(iy1);
+
+    Vec16f y1 = interpRow(iy1);
+    Vec16f y2 = interpRow(iy1 + 1);
+    Vec16f sig = y1 + yFrac * (y2 - y1);
+
+    Vec16ib isBicubic(interpType == interpBicubic);
+    if (horizontal_or(isBicubic)) {
+      Vec16f y3 = interpRow(iy1 + 2);
+      Vec16f y4 = interpRow(iy1 + 3);
+      sig = select(isBicubic, cubicInterpForward(y1, y2, y3, y4, yFrac), sig);
+    }
+    return select(isNearest, y1, sig);
   }
 };
 
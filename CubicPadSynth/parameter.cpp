@@ -71,3 +71,7 @@ IntScale<double> Scales::unisonPanType(9);
 
 IntScale<double> Scales::nVoice(7);
 LogScale<double> Scales::smoothness(0.0, 0.5, 0.1, 0.04);
+
+IntScale<double> Scales::cpuGovernorLevel(3);
+
+IntScale<double> Scales::oscInterpolation(2);
@@ -33,6 +33,7 @@ static const uint32_t kParameterIsAutomable = 0x01;
 static const uint32_t kParameterIsBoolean = 0x02;
 static const uint32_t kParameterIsInteger = 0x04;
 static const uint32_t kParameterIsLogarithmic = 0x08;
+static const uint32_t kParameterIsOutput = 0x10;
 #endif
 
 constexpr int32_t nOvertone = 360;
@@ -124,6 +125,12 @@ enum ID {
   refreshLFO,
   refreshTable,
 
+  cpuGovernor,
+  cpuGovernorLevel,
+
+  oscInterpolation,
+  unisonReduceInterpolation,
+
   ID_ENUM_LENGTH,
 };
 } // namespace ParameterID
@@ -178,15 +185,17 @@ struct Scales {
 
   static SomeDSP::IntScale<double> nVoice;
   static SomeDSP::LogScale<double> smoothness;
+
+  static SomeDSP::IntScale<double> cpuGovernorLevel;
+
+  static SomeDSP::IntScale<double> oscInterpolation;
 };
 
 struct GlobalParameter : public ParameterInterface {
-  std::vector<std::unique_ptr<ValueInterface>> value;
+  ParameterStore<ParameterID::ID_ENUM_LENGTH> value;
 
   GlobalParameter()
   {
-    value.resize(ParameterID::ID_ENUM_LENGTH);
-
     using ID = ParameterID::ID;
     using LinearValue = FloatValue<SomeDSP::LinearScale<double>>;
     using LogValue = FloatValue<SomeDSP::LogScale<double>>;
@@ -196,33 +205,28 @@ struct GlobalParameter : public ParameterInterface {
     value[ID::bypass] = std::make_unique<IntValue>(
       0, Scales::boolScale, "bypass", kParameterIsAutomable | kParameterIsBoolean);
 
-    std::string gainLabel("gain");
-    std::string widthLabel("width");
-    std::string pitchLabel("pitch");
-    std::string phaseLabel("phase");
+    static constexpr IndexedName<nOvertone> gainLabel("gain");
+    static constexpr IndexedName<nOvertone> widthLabel("width");
+    static constexpr IndexedName<nOvertone> pitchLabel("pitch");
+    static constexpr IndexedName<nOvertone> phaseLabel("phase");
     for (size_t idx = 0; idx < nOvertone; ++idx) {
-      auto indexStr = std::to_string(idx);
       value[ID::overtoneGain0 + idx] = std::make_unique<DecibelValue>(
         Scales::overtoneGain.invmap(1.0 / (idx + 1)), Scales::overtoneGain,
-        (gainLabel + indexStr).c_str(), kParameterIsAutomable);
+        gainLabel[idx], kParameterIsAutomable);
       value[ID::overtoneWidth0 + idx] = std::make_unique<LinearValue>(
-        0.5, Scales::overtoneWidth, (widthLabel + indexStr).c_str(),
-        kParameterIsAutomable);
+        0.5, Scales::overtoneWidth, widthLabel[idx], kParameterIsAutomable);
       value[ID::overtonePitch0 + idx] = std::make_unique<LogValue>(
-        Scales::overtonePitch.invmap(1.0), Scales::overtonePitch,
-        (pitchLabel + indexStr).c_str(), kParameterIsAutomable);
-      value[ID::overtonePhase0 + idx] = std::make_unique<LinearValue>(
-        1.0, Scales::overtonePhase, (phaseLabel + indexStr).c_str(),
+        Scales::overtonePitch.invmap(1.0), Scales::overtonePitch, pitchLabel[idx],
         kParameterIsAutomable);
+      value[ID::overtonePhase0 + idx] = std::make_unique<LinearValue>(
+        1.0, Scales::overtonePhase, phaseLabel[idx], kParameterIsAutomable);
     }
 
-    std::string lfoWavetableLabel("lfoWavetable");
+    static constexpr IndexedName<nLFOWavetable> lfoWavetableLabel("lfoWavetable");
     for (size_t idx = 0; idx < nLFOWavetable; ++idx) {
-      auto indexStr = std::to_string(idx);
       value[ID::lfoWavetable0 + idx] = std::make_unique<LinearValue>(
         Scales::lfoWavetable.invmap(sin(SomeDSP::twopi * idx / double(nLFOWavetable))),
-        Scales::lfoWavetable, (lfoWavetableLabel + indexStr).c_str(),
-        kParameterIsAutomable);
+        Scales::lfoWavetable, lfoWavetableLabel[idx], kParameterIsAutomable);
     }
 
     value[ID::tableBaseFrequency] = std::make_unique<LogValue>(
@@ -372,6 +376,19 @@ struct GlobalParameter : public ParameterInterface {
       0, Scales::boolScale, "refreshLFO", kParameterIsAutomable | kParameterIsBoolean);
     value[ID::refreshTable] = std::make_unique<IntValue>(
       0, Scales::boolScale, "refreshTable", kParameterIsAutomable | kParameterIsBoolean);
+
+    value[ID::cpuGovernor] = std::make_unique<IntValue>(
+      0, Scales::boolScale, "cpuGovernor", kParameterIsAutomable | kParameterIsBoolean);
+    value[ID::cpuGovernorLevel] = std::make_unique<IntValue>(
+      0, Scales::cpuGovernorLevel, "cpuGovernorLevel",
+      kParameterIsOutput | kParameterIsInteger);
+
+    value[ID::oscInterpolation] = std::make_unique<IntValue>(
+      2, Scales::oscInterpolation, "oscInterpolation",
+      kParameterIsAutomable | kParameterIsInteger);
+    value[ID::unisonReduceInterpolation] = std::make_unique<IntValue>(
+      1, Scales::boolScale, "unisonReduceInterpolation",
+      kParameterIsAutomable | kParameterIsBoolean);
   }
 
 #ifndef TEST_BUILD
@@ -354,10 +354,16 @@ void DSPCORE_NAME::noteOn(int32_t identifier, int16_t pitch, float tuning, float
 
   std::vector<size_t> noteIndices(0);
 
+  // Reuse note of same ID. This happens when a key held by pedal is struck again.
   for (size_t index = 0; index < nVoice; ++index) {
-    if (notes[index].id == identifier) noteIndices.push_back(index);
-    if (notes[index].state == NoteState::rest) noteIndices.push_back(index);
     if (noteIndices.size() >= nUnison) break;
+    if (notes[index].id == identifier && notes[index].state != NoteState::rest)
+      noteIndices.push_back(index);
+  }
+
+  for (size_t index = 0; index < nVoice; ++index) {
+    if (noteIndices.size() >= nUnison) break;
+    if (notes[index].state == NoteState::rest) noteIndices.push_back(index);
   }
 
   if (noteIndices.size() < nUnison) {
@@ -368,6 +374,8 @@ void DSPCORE_NAME::noteOn(int32_t identifier, int16_t pitch, float tuning, float
     });
 
     for (auto &index : indices) {
+      if (notes[index].state == NoteState::rest) continue;
+      if (notes[index].id == identifier) continue;
       fillTransitionBuffer(index);
       noteIndices.push_back(index);
       if (noteIndices.size() >= nUnison) break;
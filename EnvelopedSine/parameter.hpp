@@ -141,12 +141,10 @@ struct Scales {
 };
 
 struct GlobalParameter : public ParameterInterface {
-  std::vector<std::unique_ptr<ValueInterface>> value;
+  ParameterStore<ParameterID::ID_ENUM_LENGTH> value;
 
   GlobalParameter()
   {
-    value.resize(ParameterID::ID_ENUM_LENGTH);
-
     using ID = ParameterID::ID;
     using LinearValue = FloatValue<SomeDSP::LinearScale<double>>;
     using LogValue = FloatValue<SomeDSP::LogScale<double>>;
@@ -156,22 +154,20 @@ struct GlobalParameter : public ParameterInterface {
     value[ID::bypass] = std::make_unique<IntValue>(
       0, Scales::boolScale, "bypass", kParameterIsAutomable | kParameterIsBoolean);
 
-    std::string attackLabel("attack");
-    std::string curveLabel("curve");
-    std::string overtoneLabel("overtone");
-    std::string saturationLabel("saturation");
+    static constexpr IndexedName<nOvertone> attackLabel("attack");
+    static constexpr IndexedName<nOvertone> curveLabel("curve");
+    static constexpr IndexedName<nOvertone> overtoneLabel("overtone");
+    static constexpr IndexedName<nOvertone> saturationLabel("saturation");
     for (size_t i = 0; i < nOvertone; ++i) {
-      auto indexStr = std::to_string(i);
       value[ID::attack0 + i] = std::make_unique<LogValue>(
-        0.0, Scales::envelopeA, (attackLabel + indexStr).c_str(), kParameterIsAutomable);
+        0.0, Scales::envelopeA, attackLabel[i], kParameterIsAutomable);
       value[ID::decay0 + i] = std::make_unique<LogValue>(
-        0.5, Scales::envelopeD, (curveLabel + indexStr).c_str(), kParameterIsAutomable);
+        0.5, Scales::envelopeD, curveLabel[i], kParameterIsAutomable);
       value[ID::overtone0 + i] = std::make_unique<DecibelValue>(
-        Scales::gainDecibel.invmap(1.0 / (i + 1)), Scales::gainDecibel,
-        (overtoneLabel + indexStr).c_str(), kParameterIsAutomable);
-      value[ID::saturation0 + i] = std::make_unique<LogValue>(
-        0.0, Scales::saturation, (saturationLabel + indexStr).c_str(),
+        Scales::gainDecibel.invmap(1.0 / (i + 1)), Scales::gainDecibel, overtoneLabel[i],
         kParameterIsAutomable);
+      value[ID::saturation0 + i] = std::make_unique<LogValue>(
+        0.0, Scales::saturation, saturationLabel[i], kParameterIsAutomable);
     }
 
     value[ID::gain]
@@ -17,6 +17,8 @@
 
 #include "dspcore.hpp"
 
+#include "../../lib/vcl/vectormath_exp.h"
+
 #if INSTRSET >= 10
   #define NOTE_NAME Note_AVX512
   #define DSPCORE_NAME DSPCore_AVX512
@@ -57,6 +59,12 @@ inline float paramMilliToPitch(float semi, float milli, float equalTemperament)
     powf(2.0f, (1000.0f * floorf(semi) + milli) / (equalTemperament * 1000.0f)), 4096);
 }
 
+// Range of MPE timbre (CC 74) applied to overtone gain. 1 means +-6 dB/oct tilt.
+constexpr float timbreTiltRange = 1.0f;
+
+// Release time of notes dropped by CPU governor. In seconds.
+constexpr float governorFadeTime = 0.02f;
+
 // https://en.wikipedia.org/wiki/Cent_(music)#Piecewise_linear_approximation
 inline float centApprox(float cent) { return 1.0f + 0.0005946f * cent; }
 
@@ -77,10 +85,12 @@ void NOTE_NAME<Sample>::noteOn(
   Sample frequency,
   Sample velocity,
   GlobalParameter &param,
+  const NoteParameter &noteParam,
   White<float> &rng)
 {
   state = NoteState::active;
   id = noteId;
+  isFading = false;
   this->normalizedKey = normalizedKey;
   this->frequency = frequency;
   this->velocity = velocity;
@@ -107,30 +117,17 @@ void NOTE_NAME<Sample>::noteOn(
     * semiToPitch(semiSign * param.value[ID::highShelfPitch]->getFloat(), eqTemp);
   const Sample highShelfGain = param.value[ID::highShelfGain]->getFloat();
 
+  // Not tied to CPU governor level. Dropping audible aliased partials at some levels
+  // changes loudness when the level changes.
   const auto enableAliasing = param.value[ID::aliasing]->getInt();
 
-  std::array<float, nPitch> notePitch;
-  std::array<float, nPitch> noteGain;
-  for (size_t i = 0; i < nPitch; ++i) {
-    notePitch[i] = paramMilliToPitch(
-      semiSign * param.value[ID::semi0 + i]->getFloat(),
-      param.value[ID::milli0 + i]->getFloat(), eqTemp);
-    noteGain[i] = param.value[ID::gain0 + i]->getFloat();
-  }
-
-  Vec16f overtonePitch;
+  const Vec16f overtonePitch(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16);
   Vec16f overtoneGain;
-  for (size_t i = 0; i < nOvertone; ++i) {
-    overtonePitch.insert(i, float(i + 1));
-    overtoneGain.insert(i, float(param.value[ID::overtone0 + i]->getFloat()));
-  }
+  overtoneGain.load_a(noteParam.overtoneGain.data());
 
   for (size_t chord = 0; chord < nChord; ++chord) {
-    float chordFreq = frequency
-      * paramMilliToPitch(
-                        semiSign * param.value[ID::chordSemi0 + chord]->getFloat(),
-                        param.value[ID::chordMilli0 + chord]->getFloat(), eqTemp);
-    float chordGain = param.value[ID::chordGain0 + chord]->getFloat();
+    float chordFreq = frequency * noteParam.chordPitch[chord];
+    float chordGain = noteParam.chordGain[chord];
     for (size_t pitch = 0; pitch < nPitch; ++pitch) {
       // Equation to calculate a sine wave frquency.
       // freq = noteFreq * (overtone + 1) * (pitch + 1)
@@ -144,7 +141,7 @@ void NOTE_NAME<Sample>::noteOn(
       if (pitchModulo != 1) // Modulo operation. modf isn't available in vcl.
         modPt = modPt - pitchModulo * floor(modPt / pitchModulo);
 
-      Vec16f oscFreq = chordFreq * notePitch[pitch] * (1.0f + modPt);
+      Vec16f oscFreq = chordFreq * noteParam.pitch[pitch] * (1.0f + modPt);
       oscillator[chord].frequency[pitch] = oscFreq;
 
       Vec16f shelving(1.0f);
@@ -160,53 +157,107 @@ void NOTE_NAME<Sample>::noteOn(
       if (!enableAliasing) oscGain = select(oscFreq >= nyquist, 0.0f, oscGain);
 
       oscillator[chord].gain[pitch]
-        = oscGain * chordGain * noteGain[pitch] * shelving * (1.0f + randGainAmt * rndGn);
+        = oscGain * chordGain * noteParam.gain[pitch] * shelving
+        * (1.0f + randGainAmt * rndGn);
     }
   }
 
   for (auto &osc : oscillator) osc.setup(sampleRate);
 
-  for (size_t i = 0; i < nChord; ++i)
-    chordPan[i] = param.value[ID::chordPan0 + i]->getFloat();
+  chordPan = noteParam.chordPan;
 
   gainEnvelope.reset(
     param.value[ID::gainA]->getFloat(), param.value[ID::gainD]->getFloat(),
     param.value[ID::gainS]->getFloat(), param.value[ID::gainR]->getFloat(), frequency,
     param.value[ID::gainEnvelopeCurve]->getFloat());
   gainEnvCurve = param.value[ID::gainEnvelopeCurve]->getFloat();
+
+  setExpression(NoteExpression(), true);
 }
 
 template<typename Sample> void NOTE_NAME<Sample>::release()
 {
-  if (state == NoteState::rest) return;
+  if (state == NoteState::rest || isFading) return;
   state = NoteState::release;
   gainEnvelope.release();
 }
 
+template<typename Sample> void NOTE_NAME<Sample>::fadeOut()
+{
+  if (state == NoteState::rest) return;
+  state = NoteState::release;
+  isFading = true;
+  gainEnvelope.release(governorFadeTime);
+}
+
 template<typename Sample> void NOTE_NAME<Sample>::rest() { state = NoteState::rest; }
 
-template<typename Sample> std::array<Sample, 2> NOTE_NAME<Sample>::process()
+template<typename Sample>
+void NOTE_NAME<Sample>::setExpression(const NoteExpression &expression, bool reset)
 {
-  if (state == NoteState::rest) return {0, 0};
+  const Vec16f overtoneNumber(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16);
 
-  std::array<Sample, 2> out{};
-  for (size_t i = 0; i < nChord; ++i) {
-    auto sig = oscillator[i].process();
-    out[0] += sig * (Sample(1) - chordPan[i]);
-    out[1] += sig * chordPan[i];
-  }
+  bendTarget = somepow<Sample>(2, expression.bend / Sample(12));
+  overtoneTiltTarget = pow(overtoneNumber, Vec16f(timbreTiltRange * expression.timbre));
+  pressure.push(expression.pressure);
+  if (!reset) return;
+
+  bendRatio = bendTarget;
+  for (auto &osc : oscillator) osc.setPitchRatio(sampleRate, bendRatio);
+  overtoneTilt = overtoneTiltTarget;
+  pressure.reset(expression.pressure);
+}
 
-  const auto gainEnv = gainEnvelope.process();
-  if (gainEnvelope.isTerminated()) rest();
+// Called once per processing cycle. Retuning is only done while bend is moving.
+template<typename Sample> void NOTE_NAME<Sample>::updateExpression(Sample kp)
+{
+  overtoneTilt += kp * (overtoneTiltTarget - overtoneTilt);
 
-  gain = velocity
-    * (gainEnv
-       + gainEnvCurve
-         * (juce::dsp::FastMathApproximations::tanh(2.0f * gainEnvCurve * gainEnv) - gainEnv));
-  out[0] *= gain;
-  out[1] *= gain;
+  if (bendRatio == bendTarget) return;
+  bendRatio += kp * (bendTarget - bendRatio);
+  if (somefabs<Sample>(bendTarget - bendRatio) < Sample(1e-5)) bendRatio = bendTarget;
+  for (auto &osc : oscillator) osc.setPitchRatio(sampleRate, bendRatio);
+}
 
-  return out;
+// Adds `length` samples to `out0` and `out1`. `length` must be `noteBlockSize` or less.
+template<typename Sample>
+void NOTE_NAME<Sample>::process(size_t length, Vec16f *out0, Vec16f *out1)
+{
+  if (state == NoteState::rest) return;
+
+  // Envelope may terminate in the block. Remaining samples are silence.
+  std::array<Sample, noteBlockSize> blockGain;
+  for (size_t n = 0; n < length; ++n) {
+    const auto gainEnv = gainEnvelope.process();
+    gain = velocity * (Sample(1) + pressure.process())
+      * (gainEnv
+         + gainEnvCurve
+           * (juce::dsp::FastMathApproximations::tanh(2.0f * gainEnvCurve * gainEnv)
+              - gainEnv));
+    blockGain[n] = gain;
+    if (gainEnvelope.isTerminated()) {
+      rest();
+      length = n + 1;
+      break;
+    }
+  }
+
+  std::array<Vec16f, noteBlockSize> sig;
+  for (size_t i = 0; i < nChord; ++i) {
+    oscillator[i].process(length, overtoneTilt, sig.data());
+    for (size_t n = 0; n < length; ++n) {
+      out0[n] += blockGain[n] * (Sample(1) - chordPan[i]) * sig[n];
+      out1[n] += blockGain[n] * chordPan[i] * sig[n];
+    }
+  }
+}
+
+template<typename Sample> std::array<Sample, 2> NOTE_NAME<Sample>::process()
+{
+  Vec16f sum0 = 0;
+  Vec16f sum1 = 0;
+  process(1, &sum0, &sum1);
+  return {horizontal_add(sum0), horizontal_add(sum1)};
 }
 
 void DSPCORE_NAME::setup(double sampleRate)
@@ -227,6 +278,8 @@ void DSPCORE_NAME::setup(double sampleRate)
   transitionBuffer.resize(1 + size_t(sampleRate * 0.005), {0, 0});
 
   startup();
+
+  param.value.markChanged();
 }
 
 void DSPCORE_NAME::reset()
@@ -237,14 +290,18 @@ void DSPCORE_NAME::reset()
   for (auto &chrs : chorus) chrs.reset();
 
   startup();
+
+  param.value.markChanged();
 }
 
 void DSPCORE_NAME::startup() { rng.seed = param.value[ParameterID::seed]->getInt(); }
 
-void DSPCORE_NAME::setParameters()
+void DSPCORE_NAME::setParameters(size_t length)
 {
   using ID = ParameterID::ID;
 
+  param.value.consumeChanged();
+
   SmootherCommon<float>::setTime(param.value[ID::smoothness]->getFloat());
 
   interpTremoloMix.push(param.value[ID::chorusMix]->getFloat());
@@ -254,14 +311,36 @@ void DSPCORE_NAME::setParameters()
   nVoice = 1 << param.value[ID::nVoice]->getInt();
   if (nVoice > notes.size()) nVoice = notes.size();
 
+  const auto governorLevel = param.value[ID::cpuGovernorLevel]->getInt();
+  if (governorLevel > 0) {
+    nVoice = std::max<size_t>(nVoice >> governorLevel, 1);
+    fadeOutExcessNotes();
+  }
+
+  // Exponential smoother coefficient for `length` samples. Expression is updated once
+  // per block, and blocks are split at parameter events, so `length` varies.
+  const float blockKp = 1.0f - powf(1.0f - SmootherCommon<float>::kp, float(length));
+
+  const bool isNoteParameterChanged = param.value.isChanged(ID::gain0, ID::chordPan3)
+    || param.value.isChanged(ID::negativeSemi)
+    || param.value.isChanged(ID::equalTemperament);
+  if (isNoteParameterChanged) refreshNoteParameter();
+
+  // Envelope coefficients take a few `pow` per note. Only recompute them on change.
+  const bool isEnvelopeChanged = param.value.isChanged(ID::gainA, ID::gainR);
+
   for (auto &note : notes) {
     if (note.state == NoteState::rest) continue;
-    note.gainEnvelope.set(
-      param.value[ID::gainA]->getFloat(), param.value[ID::gainD]->getFloat(),
-      param.value[ID::gainS]->getFloat(), param.value[ID::gainR]->getFloat(),
-      note.frequency);
+    if (isEnvelopeChanged && !note.isFading) {
+      note.gainEnvelope.set(
+        param.value[ID::gainA]->getFloat(), param.value[ID::gainD]->getFloat(),
+        param.value[ID::gainS]->getFloat(), param.value[ID::gainR]->getFloat(),
+        note.frequency);
+    }
+    note.updateExpression(blockKp);
   }
 
+  // `LinearSmoother` in chorus requires push on every cycle to reach the target.
   for (size_t i = 0; i < chorus.size(); ++i) {
     chorus[i].setParam(
       param.value[ID::chorusFrequency]->getFloat(),
@@ -282,40 +361,51 @@ void DSPCORE_NAME::process(const size_t length, float *out0, float *out1)
 
   std::array<float, 2> frame{};
   std::array<float, 2> chorusOut{};
-  for (size_t i = 0; i < length; ++i) {
-    processMidiNote(i);
+  for (size_t start = 0; start < length;) {
+    processMidiNote(start);
 
-    frame.fill(0.0f);
+    // Notes are rendered in blocks, which are split at next MIDI note event.
+    size_t end = std::min(start + noteBlockSize, length);
+    for (const auto &nt : midiNotes) {
+      if (nt.frame > start && nt.frame < end) end = nt.frame;
+    }
 
+    std::fill(noteSum0.begin(), noteSum0.begin() + (end - start), Vec16f(0.0f));
+    std::fill(noteSum1.begin(), noteSum1.begin() + (end - start), Vec16f(0.0f));
     for (auto &note : notes) {
       if (note.state == NoteState::rest) continue;
-      auto noteSig = note.process();
-      frame[0] += noteSig[0];
-      frame[1] += noteSig[1];
+      note.process(end - start, noteSum0.data(), noteSum1.data());
     }
 
-    if (isTransitioning) {
-      frame[0] += transitionBuffer[mptIndex][0];
-      frame[1] += transitionBuffer[mptIndex][1];
-      transitionBuffer[mptIndex].fill(0.0f);
-      mptIndex = (mptIndex + 1) % transitionBuffer.size();
-      if (mptIndex == mptStop) isTransitioning = false;
-    }
+    for (size_t i = start; i < end; ++i) {
+      frame[0] = horizontal_add(noteSum0[i - start]);
+      frame[1] = horizontal_add(noteSum1[i - start]);
+
+      if (isTransitioning) {
+        frame[0] += transitionBuffer[mptIndex][0];
+        frame[1] += transitionBuffer[mptIndex][1];
+        transitionBuffer[mptIndex].fill(0.0f);
+        mptIndex = (mptIndex + 1) % transitionBuffer.size();
+        if (mptIndex == mptStop) isTransitioning = false;
+      }
+
+      const auto chorusIn = frame[0] + frame[1];
+      chorusOut.fill(0.0f);
+      for (auto &chrs : chorus) {
+        const auto out = chrs.process(chorusIn);
+        chorusOut[0] += out[0];
+        chorusOut[1] += out[1];
+      }
+      chorusOut[0] /= chorus.size();
+      chorusOut[1] /= chorus.size();
 
-    const auto chorusIn = frame[0] + frame[1];
-    chorusOut.fill(0.0f);
-    for (auto &chrs : chorus) {
-      const auto out = chrs.process(chorusIn);
-      chorusOut[0] += out[0];
-      chorusOut[1] += out[1];
+      const auto chorusMix = interpTremoloMix.process();
+      const auto masterGain = interpMasterGain.process();
+      out0[i] = masterGain * (frame[0] + chorusMix * (chorusOut[0] - frame[0]));
+      out1[i] = masterGain * (frame[1] + chorusMix * (chorusOut[1] - frame[1]));
     }
-    chorusOut[0] /= chorus.size();
-    chorusOut[1] /= chorus.size();
 
-    const auto chorusMix = interpTremoloMix.process();
-    const auto masterGain = interpMasterGain.process();
-    out0[i] = masterGain * (frame[0] + chorusMix * (chorusOut[0] - frame[0]));
-    out1[i] = masterGain * (frame[1] + chorusMix * (chorusOut[1] - frame[1]));
+    start = end;
   }
 }
 
@@ -363,7 +453,74 @@ void DSPCORE_NAME::noteOn(int32_t noteId, int16_t pitch, float tuning, float vel
   auto normalizedKey = float(pitch) / 127.0f;
   lastNoteFreq
     = midiNoteToFrequency(pitch, tuning, param.value[ParameterID::pitchBend]->getFloat());
-  notes[noteIdx].noteOn(noteId, normalizedKey, lastNoteFreq, velocity, param, rng);
+  notes[noteIdx].noteOn(
+    noteId, normalizedKey, lastNoteFreq, velocity, param, noteParam, rng);
+}
+
+void DSPCORE_NAME::setNoteExpression(int32_t noteId, NoteExpression expression)
+{
+  // Notes which are not yet started in this cycle.
+  for (auto &nt : midiNotes) {
+    if (nt.isNoteOn && nt.id == noteId) nt.expression = expression;
+  }
+  applyNoteExpression(noteId, expression, false);
+}
+
+void DSPCORE_NAME::applyNoteExpression(
+  int32_t noteId, const NoteExpression &expression, bool reset)
+{
+  for (auto &note : notes) {
+    if (note.id == noteId && note.state != NoteState::rest)
+      note.setExpression(expression, reset);
+  }
+}
+
+// Fades out the quietest notes until the number of sounding notes fits in nVoice.
+void DSPCORE_NAME::fadeOutExcessNotes()
+{
+  size_t nSounding = 0;
+  for (auto &note : notes) {
+    if (note.state != NoteState::rest && !note.isFading) ++nSounding;
+  }
+
+  for (; nSounding > nVoice; --nSounding) {
+    size_t target = notes.size();
+    for (size_t idx = 0; idx < notes.size(); ++idx) {
+      auto &note = notes[idx];
+      if (note.state == NoteState::rest || note.isFading) continue;
+      if (
+        target >= notes.size()
+        || (!note.gainEnvelope.isAttacking() && note.gain < notes[target].gain))
+        target = idx;
+    }
+    notes[target].fadeOut();
+  }
+}
+
+void DSPCORE_NAME::refreshNoteParameter()
+{
+  using ID = ParameterID::ID;
+
+  const float semiSign = param.value[ID::negativeSemi]->getInt() ? -1.0f : 1.0f;
+  const float eqTemp = param.value[ID::equalTemperament]->getInt();
+
+  for (size_t i = 0; i < nOvertone; ++i)
+    noteParam.overtoneGain[i] = param.value[ID::overtone0 + i]->getFloat();
+
+  for (size_t i = 0; i < nPitch; ++i) {
+    noteParam.pitch[i] = paramMilliToPitch(
+      semiSign * param.value[ID::semi0 + i]->getFloat(),
+      param.value[ID::milli0 + i]->getFloat(), eqTemp);
+    noteParam.gain[i] = param.value[ID::gain0 + i]->getFloat();
+  }
+
+  for (size_t i = 0; i < nChord; ++i) {
+    noteParam.chordPitch[i] = paramMilliToPitch(
+      semiSign * param.value[ID::chordSemi0 + i]->getFloat(),
+      param.value[ID::chordMilli0 + i]->getFloat(), eqTemp);
+    noteParam.chordGain[i] = param.value[ID::chordGain0 + i]->getFloat();
+    noteParam.chordPan[i] = param.value[ID::chordPan0 + i]->getFloat();
+  }
 }
 
 void DSPCORE_NAME::noteOff(int32_t noteId)
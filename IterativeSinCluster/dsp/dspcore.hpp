@@ -19,6 +19,7 @@
 
 #include "../../common/dsp/constants.hpp"
 #include "../../common/dsp/smoother.hpp"
+#include "../../common/midi.hpp"
 #include "../parameter.hpp"
 #include "delay.hpp"
 #include "envelope.hpp"
@@ -38,9 +39,24 @@ constexpr size_t nPitch = 8;
 constexpr size_t nChord = 4;
 constexpr size_t nOvertone = 16;
 constexpr size_t biquadOscSize = nPitch * nOvertone;
+constexpr size_t noteBlockSize = 64; // Max length of `Note::process()` in samples.
 
 enum class NoteState { active, release, rest };
 
+/*
+Array parameters converted to DSP units. `DSPCore::setParameters()` refreshes it only
+when the source parameters are changed, and `Note::noteOn()` loads it into vector
+registers without per element conversion.
+*/
+struct NoteParameter {
+  alignas(64) std::array<float, nOvertone> overtoneGain{};
+  alignas(64) std::array<float, nPitch> pitch{};
+  alignas(64) std::array<float, nPitch> gain{};
+  alignas(64) std::array<float, nChord> chordPitch{};
+  alignas(64) std::array<float, nChord> chordGain{};
+  alignas(64) std::array<float, nChord> chordPan{};
+};
+
 #define NOTE_CLASS(INSTRSET)                                                             \
   template<typename Sample> class Note_##INSTRSET {                                      \
   public:                                                                                \
@@ -53,6 +69,7 @@ enum class NoteState { active, release, rest };
     Sample velocity = 0;                                                                 \
     Sample gain = 0;                                                                     \
     Sample frequency = 0;                                                                \
+    bool isFading = false;                                                               \
                                                                                          \
     std::array<BiquadOsc<nPitch>, nChord> oscillator;                                    \
     std::array<Sample, nChord> chordPan{};                                               \
@@ -60,6 +77,12 @@ enum class NoteState { active, release, rest };
     ExpADSREnvelope<Sample> gainEnvelope;                                                \
     Sample gainEnvCurve = 0;                                                             \
                                                                                          \
+    Sample bendRatio = 1;                                                                \
+    Sample bendTarget = 1;                                                               \
+    Vec16f overtoneTilt = 1;                                                             \
+    Vec16f overtoneTiltTarget = 1;                                                       \
+    ExpSmoother<Sample> pressure;                                                        \
+                                                                                         \
     void setup(Sample sampleRate);                                                       \
     void noteOn(                                                                         \
       int32_t noteId,                                                                    \
@@ -67,9 +90,14 @@ enum class NoteState { active, release, rest };
       Sample frequency,                                                                  \
       Sample velocity,                                                                   \
       GlobalParameter &param,                                                            \
+      const NoteParameter &noteParam,                                                    \
       White<float> &rng);                                                                \
     void release();                                                                      \
+    void fadeOut();                                                                      \
     void rest();                                                                         \
+    void setExpression(const NoteExpression &expression, bool reset);                    \
+    void updateExpression(Sample kp);                                                    \
+    void process(size_t length, Vec16f *out0, Vec16f *out1);                             \
     std::array<Sample, 2> process();                                                     \
   };
 
@@ -88,10 +116,11 @@ public:
   virtual void setup(double sampleRate) = 0;
   virtual void reset() = 0;   // Stop sounds.
   virtual void startup() = 0; // Reset phase, random seed etc.
-  virtual void setParameters() = 0;
+  virtual void setParameters(size_t length) = 0; // `length` of the following block.
   virtual void process(const size_t length, float *out0, float *out1) = 0;
   virtual void noteOn(int32_t noteId, int16_t pitch, float tuning, float velocity) = 0;
   virtual void noteOff(int32_t noteId) = 0;
+  virtual void setNoteExpression(int32_t noteId, NoteExpression expression) = 0;
 
   struct MidiNote {
     bool isNoteOn;
@@ -100,6 +129,7 @@ public:
     int16_t pitch;
     float tuning;
     float velocity;
+    NoteExpression expression;
   };
 
   std::vector<MidiNote> midiNotes;
@@ -127,10 +157,11 @@ mpt stands for Max Poly Transition. I guess this sounds weird for English native
     void setup(double sampleRate) override;                                              \
     void reset() override;                                                               \
     void startup() override;                                                             \
-    void setParameters() override;                                                       \
+    void setParameters(size_t length) override;                                          \
     void process(const size_t length, float *out0, float *out1) override;                \
     void noteOn(int32_t noteId, int16_t pitch, float tuning, float velocity) override;   \
     void noteOff(int32_t noteId) override;                                               \
+    void setNoteExpression(int32_t noteId, NoteExpression expression) override;          \
                                                                                          \
     void pushMidiNote(                                                                   \
       bool isNoteOn,                                                                     \
@@ -158,15 +189,22 @@ mpt stands for Max Poly Transition. I guess this sounds weird for English native
               return nt.frame == frame;                                                  \
             });                                                                          \
         if (it == std::end(midiNotes)) return;                                           \
-        if (it->isNoteOn)                                                                \
+        if (it->isNoteOn) {                                                              \
           noteOn(it->id, it->pitch, it->tuning, it->velocity);                           \
-        else                                                                             \
+          applyNoteExpression(it->id, it->expression, true);                             \
+        } else {                                                                         \
           noteOff(it->id);                                                               \
+        }                                                                                \
         midiNotes.erase(it);                                                             \
       }                                                                                  \
     }                                                                                    \
                                                                                          \
   private:                                                                               \
+    void applyNoteExpression(                                                            \
+      int32_t noteId, const NoteExpression &expression, bool reset);                     \
+    void fadeOutExcessNotes();                                                           \
+    void refreshNoteParameter();                                                         \
+                                                                                         \
     float sampleRate = 44100.0f;                                                         \
                                                                                          \
     White<float> rng{0};                                                                 \
@@ -174,6 +212,10 @@ mpt stands for Max Poly Transition. I guess this sounds weird for English native
     size_t nVoice = 32;                                                                  \
     std::array<Note_##INSTRSET<float>, maxVoice> notes;                                  \
     float lastNoteFreq = 1.0f;                                                           \
+    NoteParameter noteParam;                                                             \
+                                                                                         \
+    std::array<Vec16f, noteBlockSize> noteSum0;                                          \
+    std::array<Vec16f, noteBlockSize> noteSum1;                                          \
                                                                                          \
     std::array<Chorus<float>, 3> chorus;                                                 \
                                                                                          \
@@ -192,6 +192,13 @@ public:
     state = State::release;
   }
 
+  // Release in `seconds` regardless of release time. Following `set()` must be skipped.
+  void release(Sample seconds)
+  {
+    rel.reset(sampleRate, seconds);
+    release();
+  }
+
   bool isAttacking() { return state == State::attack; }
   bool isReleasing() { return state == State::release; }
   bool isTerminated() { return state == State::terminated; }
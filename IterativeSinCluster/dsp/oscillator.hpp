@@ -26,34 +26,105 @@
 
 namespace SomeDSP {
 
+/*
+`size` vectors of 16 sine oscillators. Lane `j` of input vectors is overtone `j`.
+
+`setup()` drops lanes with 0 gain and packs the rest into first `nActive` vectors, so
+partials above Nyquist or with muted overtone cost nothing. `overtone` keeps the original
+lane of packed lanes, to apply per overtone gain in `process()`.
+*/
 template<size_t size> struct alignas(64) BiquadOsc {
 public:
   std::array<Vec16f, size> frequency;
   std::array<Vec16f, size> gain;
+  std::array<Vec16i, size> overtone;
   std::array<Vec16f, size> u1;
   std::array<Vec16f, size> u0;
   std::array<Vec16f, size> k;
+  std::array<Vec16f, size> sinOmega;
+  size_t nActive = 0;
 
+  // `frequency` and `gain` must be set before calling this.
   void setup(float sampleRate)
   {
+    alignas(64) std::array<float, 16 * size> freqBuf;
+    alignas(64) std::array<float, 16 * size> gainBuf;
+    alignas(64) std::array<int32_t, 16 * size> overtoneBuf{};
     for (size_t i = 0; i < size; ++i) {
+      frequency[i].store_a(freqBuf.data() + 16 * i);
+      gain[i].store_a(gainBuf.data() + 16 * i);
+    }
+
+    // Packing in place is safe, because write index never exceeds read index.
+    size_t nLane = 0;
+    for (size_t idx = 0; idx < 16 * size; ++idx) {
+      if (gainBuf[idx] == 0.0f) continue;
+      freqBuf[nLane] = freqBuf[idx];
+      gainBuf[nLane] = gainBuf[idx];
+      overtoneBuf[nLane] = int32_t(idx % 16);
+      ++nLane;
+    }
+    nActive = (nLane + 15) / 16;
+    for (; nLane < 16 * nActive; ++nLane) {
+      freqBuf[nLane] = 0.0f;
+      gainBuf[nLane] = 0.0f;
+      overtoneBuf[nLane] = 0;
+    }
+
+    for (size_t i = 0; i < nActive; ++i) {
+      frequency[i].load_a(freqBuf.data() + 16 * i);
+      gain[i].load_a(gainBuf.data() + 16 * i);
+      overtone[i].load_a(overtoneBuf.data() + 16 * i);
+
       u1[i] = 0;
       auto omega = float(twopi) * frequency[i] / sampleRate;
       u0[i] = -sincos(&k[i], omega);
       k[i] *= 2.0f;
+      sinOmega[i] = -u0[i];
     }
   }
 
-  float process()
+  /*
+  Changes frequency to `ratio * frequency` without resetting phase and amplitude.
+  State is u1 = A sin(p) and u0 = A sin(p - w), so A cos(p) is recovered from u1 and u0,
+  then u0 is recomputed for new w.
+  */
+  void setPitchRatio(float sampleRate, float ratio)
   {
-    float sum = 0;
-    for (size_t i = 0; i < size; ++i) {
-      auto out = k[i] * u1[i] - u0[i];
-      u0[i] = u1[i];
-      u1[i] = out;
-      sum += horizontal_add(gain[i] * out);
+    for (size_t i = 0; i < nActive; ++i) {
+      Vec16f cosNew;
+      auto omega = float(twopi) * ratio * frequency[i] / sampleRate;
+      auto sinNew = sincos(&cosNew, omega);
+      auto ampCos = select(
+        abs(sinOmega[i]) > 1e-5f, (0.5f * k[i] * u1[i] - u0[i]) / sinOmega[i], 0.0f);
+      u0[i] = u1[i] * cosNew - ampCos * sinNew;
+      k[i] = 2.0f * cosNew;
+      sinOmega[i] = sinNew;
+    }
+  }
+
+  /*
+  Writes `length` samples to `out`. Lanes of `out` are not summed here. Caller mixes
+  vectors of all notes, then takes horizontal sum once per sample.
+
+  `overtoneGain` is multiplied to each overtone. It's constant in a block.
+  */
+  void process(size_t length, Vec16f overtoneGain, Vec16f *out)
+  {
+    std::array<Vec16f, size> amp;
+    for (size_t i = 0; i < nActive; ++i)
+      amp[i] = gain[i] * lookup16(overtone[i], overtoneGain) * float(1.0 / (8 * size));
+
+    for (size_t n = 0; n < length; ++n) {
+      Vec16f sum = 0;
+      for (size_t i = 0; i < nActive; ++i) {
+        auto sig = k[i] * u1[i] - u0[i];
+        u0[i] = u1[i];
+        u1[i] = sig;
+        sum += amp[i] * sig;
+      }
+      out[n] = sum;
     }
-    return sum / (8 * size);
   }
 };
 
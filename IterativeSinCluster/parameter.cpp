@@ -56,6 +56,8 @@ LogScale<double> Scales::envelopeR(0.001, 16.0, 0.5, 2.0);
 IntScale<double> Scales::nVoice(5);
 LogScale<double> Scales::smoothness(0.0, 0.5, 0.1, 0.04);
 
+IntScale<double> Scales::cpuGovernorLevel(3);
+
 // Generated from preset dump. This works, but hard coding preset data is seriously bad.
 #ifndef TEST_BUILD
 void GlobalParameter::loadProgram(uint32_t index)
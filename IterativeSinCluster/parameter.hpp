@@ -28,6 +28,7 @@ static const uint32_t kParameterIsAutomable = 0x01;
 static const uint32_t kParameterIsBoolean = 0x02;
 static const uint32_t kParameterIsInteger = 0x04;
 static const uint32_t kParameterIsLogarithmic = 0x08;
+static const uint32_t kParameterIsOutput = 0x10;
 #endif
 
 namespace ParameterID {
@@ -142,6 +143,9 @@ enum ID {
 
   pitchBend,
 
+  cpuGovernor,
+  cpuGovernorLevel,
+
   ID_ENUM_LENGTH,
 };
 } // namespace ParameterID
@@ -182,15 +186,15 @@ struct Scales {
 
   static SomeDSP::IntScale<double> nVoice;
   static SomeDSP::LogScale<double> smoothness;
+
+  static SomeDSP::IntScale<double> cpuGovernorLevel;
 };
 
 struct GlobalParameter : public ParameterInterface {
-  std::vector<std::unique_ptr<ValueInterface>> value;
+  ParameterStore<ParameterID::ID_ENUM_LENGTH> value;
 
   GlobalParameter()
   {
-    value.resize(ParameterID::ID_ENUM_LENGTH);
-
     using ID = ParameterID::ID;
 
     using ID = ParameterID::ID;
@@ -422,6 +426,12 @@ struct GlobalParameter : public ParameterInterface {
 
     value[ID::pitchBend] = std::make_unique<LinearValue>(
       0.5, Scales::defaultScale, "pitchBend", kParameterIsAutomable);
+
+    value[ID::cpuGovernor] = std::make_unique<IntValue>(
+      0, Scales::boolScale, "cpuGovernor", kParameterIsAutomable | kParameterIsBoolean);
+    value[ID::cpuGovernorLevel] = std::make_unique<IntValue>(
+      0, Scales::cpuGovernorLevel, "cpuGovernorLevel",
+      kParameterIsOutput | kParameterIsInteger);
   }
 
 #ifndef TEST_BUILD
@@ -27,6 +27,9 @@
 
 #include "DistrhoPlugin.hpp"
 #include "dsp/dspcore.hpp"
+#include "../common/governor.hpp"
+#include "../common/midi.hpp"
+#include "../common/parameterqueue.hpp"
 
 START_NAMESPACE_DISTRHO
 
@@ -51,8 +54,6 @@ public:
     }
 
     sampleRateChanged(getSampleRate());
-    lastNoteId.reserve(dsp->maxVoice + 1);
-    alreadyRecievedNote.reserve(dsp->maxVoice);
   }
 
 protected:
@@ -87,14 +88,18 @@ protected:
     parameter.symbol = parameter.name;
   }
 
+  // Value which is set but not yet applied in `run()` is returned, so host reads back
+  // what it set.
   float getParameterValue(uint32_t index) const override
   {
+    double value;
+    if (paramQueue.get(index, value)) return value;
     return dsp->param.getFloat(index);
   }
 
   void setParameterValue(uint32_t index, float value) override
   {
-    dsp->param.setParameterValue(index, value);
+    paramQueue.push(index, value);
   }
 
   void initProgramName(uint32_t index, String &programName) override
@@ -104,47 +109,60 @@ protected:
 
   void loadProgram(uint32_t index) override { dsp->param.loadProgram(index); }
 
-  void sampleRateChanged(double newSampleRate) { dsp->setup(newSampleRate); }
+  void sampleRateChanged(double newSampleRate)
+  {
+    dsp->setup(newSampleRate);
+    governor.setup(newSampleRate);
+    noteIdTable.reset();
+  }
   void activate() { dsp->startup(); }
-  void deactivate() { dsp->reset(); }
+  void deactivate()
+  {
+    dsp->reset();
+    noteIdTable.reset();
+  }
 
   void handleMidi(const MidiEvent ev)
   {
-    if (ev.size != 3) return;
+    const uint8_t status = ev.data[0] & 0xf0;
+    if (ev.size != (status == 0xd0 ? 2 : 3)) return;
+
+    const uint8_t channel = ev.data[0] & 0x0f;
 
     // Copied from nekobi code.
-    switch (ev.data[0] & 0xf0) {
+    switch (status) {
       // Note off.
-      case 0x80: {
-        auto it = std::find_if(
-          lastNoteId.begin(), lastNoteId.end(),
-          [&](const std::pair<uint8_t, uint32_t> &p) { return p.first == ev.data[1]; });
-        if (it == std::end(lastNoteId)) break;
-        dsp->pushMidiNote(false, ev.frame, it->second, 0, 0, 0);
-        lastNoteId.erase(it);
-      } break;
+      case 0x80:
+        noteIdTable.noteOff(*dsp, ev.frame, ev.data[1]);
+        break;
 
-      // Note on. data[1]: note number, data[2] velocity.
+      // Note on. data[1]: note number, data[2] velocity. Velocity 0 is note-off.
       case 0x90:
-        if (ev.data[2] > 0) {
-          auto it = std::find_if(
-            alreadyRecievedNote.begin(), alreadyRecievedNote.end(),
-            [&](const uint8_t &noteNo) { return noteNo == ev.data[1]; });
-          if (it != std::end(alreadyRecievedNote)) break;
-          dsp->pushMidiNote(
-            true, ev.frame, noteId, ev.data[1], 0.0f, ev.data[2] / float(INT8_MAX));
-          lastNoteId.push_back(std::pair<uint8_t, uint32_t>(ev.data[1], noteId));
-          alreadyRecievedNote.push_back(ev.data[1]);
-          noteId += 1;
-        }
+        if (ev.data[2] > 0)
+          noteIdTable.noteOn(*dsp, ev.frame, ev.data[1], ev.data[2], channel);
+        else
+          noteIdTable.noteOff(*dsp, ev.frame, ev.data[1]);
         break;
 
-      // Pitch bend. Center is 8192 (0x2000).
-      case 0xe0:
-        dsp->param.value[ParameterID::pitchBend]->setFromFloat(
-          ((uint16_t(ev.data[2]) << 7) + ev.data[1]) / 16384.0f);
+      // Control change. data[1]: control number, data[2]: value.
+      case 0xb0:
+        noteIdTable.controlChange(*dsp, ev.frame, channel, ev.data[1], ev.data[2]);
         break;
 
+      // Channel pressure.
+      case 0xd0:
+        noteIdTable.channelPressure(channel, ev.data[1]);
+        break;
+
+      // Pitch bend. Center is 8192 (0x2000).
+      case 0xe0: {
+        const uint16_t bend = (uint16_t(ev.data[2]) << 7) + ev.data[1];
+        if (
+          !noteIdTable.pitchBend(channel, bend)
+          && !paramQueue.schedule(ParameterID::pitchBend, bend / 16384.0f, ev.frame))
+          dsp->param.value[ParameterID::pitchBend]->setFromFloat(bend / 16384.0f);
+      } break;
+
       default:
         break;
     }
@@ -158,25 +176,58 @@ protected:
     uint32_t midiEventCount) override
   {
     if (outputs == nullptr) return;
-    if (dsp->param.value[ParameterID::bypass]->getInt()) return;
+
+    auto applyEvent = [&](const ParameterEvent &event) {
+      const double previous = dsp->param.getFloat(event.id);
+      dsp->param.setParameterValue(event.id, event.value);
+      return dsp->param.getFloat(event.id) != previous;
+    };
+    if (dsp->param.value[ParameterID::bypass]->getInt()) {
+      paramQueue.flush(applyEvent);
+      return;
+    }
 
     const auto timePos = getTimePosition();
-    if (!wasPlaying && timePos.playing) dsp->startup();
+    if (!wasPlaying && timePos.playing) {
+      dsp->startup();
+      noteIdTable.resetPedal(*dsp, 0);
+    }
     wasPlaying = timePos.playing;
 
     for (size_t i = 0; i < midiEventCount; ++i) handleMidi(midiEvents[i]);
-    alreadyRecievedNote.resize(0);
+    noteIdTable.sendExpression(*dsp);
+    noteIdTable.endCycle();
+
+    const bool isGoverned = dsp->param.value[ParameterID::cpuGovernor]->getInt();
+    if (!isGoverned) governor.reset();
+
+    // Cycle is split at the frames of parameter events. Parameters are only recomputed
+    // when an event changed them. Expression smoother catches up the skipped length.
+    paramQueue.render(
+      frames, applyEvent, [&](uint32_t offset, uint32_t length, bool isChanged) {
+        if (isChanged) {
+          dsp->setParameters(skippedLength + length);
+          skippedLength = 0;
+        } else {
+          skippedLength += length;
+        }
+
+        if (isGoverned) governor.begin();
+        dsp->process(length, outputs[0] + offset, outputs[1] + offset);
+        if (isGoverned) governor.end(length);
 
-    dsp->setParameters();
-    dsp->process(frames, outputs[0], outputs[1]);
+        for (auto &note : dsp->midiNotes) note.frame -= length;
+      });
+    dsp->param.value[ParameterID::cpuGovernorLevel]->setFromInt(governor.getLevel());
   }
 
 private:
   std::unique_ptr<DSPInterface> dsp;
   bool wasPlaying = false;
-  uint32_t noteId = 0;
-  std::vector<std::pair<uint8_t, uint32_t>> lastNoteId;
-  std::vector<uint8_t> alreadyRecievedNote;
+  NoteIdTable noteIdTable;
+  CpuGovernor governor;
+  uint32_t skippedLength = 0; // Length of sub-blocks since last `setParameters()`.
+  ParameterEventQueue<ParameterID::ID_ENUM_LENGTH, 1024> paramQueue;
 
   DISTRHO_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(IterativeSinCluster)
 };
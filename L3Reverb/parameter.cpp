@@ -30,3 +30,4 @@ IntScale<double> Scales::seed(16777215); // 2^24 - 1
 LinearScale<double> Scales::stereoCross(-1.0, 1.0);
 LogScale<double> Scales::gain(0.0, 4.0, 0.5, 1.0);
 LogScale<double> Scales::smoothness(0.0, 8.0, 0.5, 1.0);
+LogScale<double> Scales::presetMorphTime(0.0, 10.0, 0.5, 1.0);
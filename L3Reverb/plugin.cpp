@@ -25,14 +25,22 @@
 
 #include "DistrhoPlugin.hpp"
 #include "dsp/dspcore.hpp"
+#include "../common/presetbank.hpp"
 
 START_NAMESPACE_DISTRHO
 
+// User presets. Shared by all instances, and mapped on first use.
+static PresetBank &getPresetBank()
+{
+  static PresetBank bank(PresetBank::getDefaultPath("L3Reverb"));
+  return bank;
+}
+
 class L3Reverb : public Plugin {
 public:
   // Plugin(nParameters, nPrograms, nStates).
   L3Reverb()
-    : Plugin(ParameterID::ID_ENUM_LENGTH, GlobalParameter::Preset::Preset_ENUM_LENGTH, 0)
+    : Plugin(ParameterID::ID_ENUM_LENGTH, nBuiltinPreset + getPresetBank().size(), 0)
   {
     auto iset = instrset_detect();
     if (iset >= 10) {
@@ -96,10 +104,34 @@ protected:
 
   void initProgramName(uint32_t index, String &programName) override
   {
-    dsp->param.initProgramName(index, programName);
+    if (index < nBuiltinPreset)
+      dsp->param.initProgramName(index, programName);
+    else
+      programName = getPresetBank().getName(index - nBuiltinPreset);
   }
 
-  void loadProgram(uint32_t index) override { dsp->param.loadProgram(index); }
+  // Parameters are written at once, so host reads back the new preset. When
+  // `presetMorphTime` is greater than 0, DSP follows slowly. `bypass` and
+  // `presetMorphTime` are kept, because they control the morph, not the sound.
+  void loadProgram(uint32_t index) override
+  {
+    using ID = ParameterID::ID;
+
+    auto &value = dsp->param.value;
+    const auto bypass = value[ID::bypass]->getInt();
+    const auto morphTime = value[ID::presetMorphTime]->getNormalized();
+
+    if (index < nBuiltinPreset)
+      dsp->param.loadProgram(index);
+    else
+      getPresetBank().load(index - nBuiltinPreset, value);
+
+    value[ID::bypass]->setFromInt(bypass);
+    value[ID::presetMorphTime]->setFromNormalized(morphTime);
+
+    const double seconds = value[ID::presetMorphTime]->getFloat();
+    if (seconds > 0) dsp->morph.start(seconds);
+  }
 
   void sampleRateChanged(double newSampleRate) { dsp->setup(newSampleRate); }
   void activate() {}
@@ -126,6 +158,8 @@ protected:
   }
 
 private:
+  static constexpr uint32_t nBuiltinPreset = GlobalParameter::Preset::Preset_ENUM_LENGTH;
+
   std::unique_ptr<DSPInterface> dsp;
   bool wasPlaying = false;
 
@@ -130,8 +130,9 @@ inline std::array<float, 2> calcOffset(float offset, float mul)
     ap4L.feed[d4].METHOD(param.value[ID::d4Feed0 + i4]->getFloat() * offsetD4Feed[0]);   \
     ap4R.feed[d4].METHOD(param.value[ID::d4Feed0 + i4]->getFloat() * offsetD4Feed[1]);   \
     ++i4;                                                                                \
-  }                                                                                      \
-                                                                                         \
+  }
+
+#define ASSIGN_OUTPUT_PARAMETER(METHOD)                                                  \
   interpStereoCross.METHOD(param.value[ID::stereoCross]->getFloat());                    \
   interpStereoSpread.METHOD(param.value[ID::stereoSpread]->getFloat());                  \
   interpDry.METHOD(param.value[ID::dry]->getFloat());                                    \
@@ -146,6 +147,9 @@ void DSPCORE_NAME::reset()
   for (auto &dly : delay) dly.reset();
 
   ASSIGN_ALLPASS_PARAMETER(reset);
+  ASSIGN_OUTPUT_PARAMETER(reset);
+
+  param.value.markChanged();
 }
 
 void DSPCORE_NAME::startup()
@@ -164,24 +168,39 @@ void DSPCORE_NAME::setParameters(float tempo)
 {
   using ID = ParameterID::ID;
 
-  SmootherCommon<float>::setTime(param.value[ID::smoothness]->getFloat());
+  param.value.consumeChanged();
 
-  refreshSeed();
+  SmootherCommon<float>::setTime(
+    morph.getSmoothingTime(param.value[ID::smoothness]->getFloat(), sampleRate));
 
-  if (!param.value[ID::timeModulation]->getInt()) timeRng.seed(timeSeed);
-  if (!param.value[ID::innerFeedModulation]->getInt()) innerRng.seed(innerSeed);
-  if (!param.value[ID::d1FeedModulation]->getInt()) d1FeedRng.seed(d1FeedSeed);
-  if (!param.value[ID::d2FeedModulation]->getInt()) d2FeedRng.seed(d2FeedSeed);
-  if (!param.value[ID::d3FeedModulation]->getInt()) d3FeedRng.seed(d3FeedSeed);
-  if (!param.value[ID::d4FeedModulation]->getInt()) d4FeedRng.seed(d4FeedSeed);
+  // Assigning 1000+ allpass parameters is the most of the cost here. It's skipped when
+  // none of the related parameters are changed. Modulation draws new random offsets on
+  // every cycle, so it always requires the assignment.
+  bool isModulating = false;
+  for (size_t id = ID::timeModulation; id <= ID::d4FeedModulation; ++id)
+    isModulating |= param.value[id]->getInt() != 0;
+
+  if (isModulating || param.value.isChanged(ID::time0, ID::seed)) {
+    refreshSeed();
+
+    if (!param.value[ID::timeModulation]->getInt()) timeRng.seed(timeSeed);
+    if (!param.value[ID::innerFeedModulation]->getInt()) innerRng.seed(innerSeed);
+    if (!param.value[ID::d1FeedModulation]->getInt()) d1FeedRng.seed(d1FeedSeed);
+    if (!param.value[ID::d2FeedModulation]->getInt()) d2FeedRng.seed(d2FeedSeed);
+    if (!param.value[ID::d3FeedModulation]->getInt()) d3FeedRng.seed(d3FeedSeed);
+    if (!param.value[ID::d4FeedModulation]->getInt()) d4FeedRng.seed(d4FeedSeed);
+
+    ASSIGN_ALLPASS_PARAMETER(push);
+  }
 
-  ASSIGN_ALLPASS_PARAMETER(push);
+  ASSIGN_OUTPUT_PARAMETER(push);
 }
 
 void DSPCORE_NAME::process(
   const size_t length, const float *in0, const float *in1, float *out0, float *out1)
 {
   SmootherCommon<float>::setBufferSize(length);
+  morph.process(length);
 
   for (size_t i = 0; i < length; ++i) {
     const auto cross = interpStereoCross.process();
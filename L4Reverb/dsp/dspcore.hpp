@@ -19,6 +19,7 @@
 
 #include "../../common/dsp/constants.hpp"
 #include "../../common/dsp/smoother.hpp"
+#include "../../common/presetmorph.hpp"
 #include "../parameter.hpp"
 
 #include "delay.hpp"
@@ -33,6 +34,7 @@ public:
   virtual ~DSPInterface(){};
 
   GlobalParameter param;
+  PresetMorph morph;
 
   virtual void setup(double sampleRate) = 0;
   virtual void reset() = 0;   // Stop sounds.
@@ -78,6 +78,8 @@ enum ID {
   smoothness,
   bypass,
 
+  presetMorphTime,
+
   ID_ENUM_LENGTH,
 };
 } // namespace ParameterID
@@ -93,52 +95,47 @@ struct Scales {
   static SomeDSP::LinearScale<double> stereoCross;
   static SomeDSP::LogScale<double> gain;
   static SomeDSP::LogScale<double> smoothness;
+  static SomeDSP::LogScale<double> presetMorphTime;
 };
 
 struct GlobalParameter : public ParameterInterface {
-  std::vector<std::unique_ptr<ValueInterface>> value;
+  ParameterStore<ParameterID::ID_ENUM_LENGTH> value;
 
   GlobalParameter()
   {
-    value.resize(ParameterID::ID_ENUM_LENGTH);
-
     using ID = ParameterID::ID;
     using LinearValue = FloatValue<SomeDSP::LinearScale<double>>;
     using LogValue = FloatValue<SomeDSP::LogScale<double>>;
 
-    std::string timeLabel("time");
-    std::string innerFeedLabel("innerFeed");
-    std::string d1FeedLabel("d1Feed");
+    static constexpr IndexedName<nDepth1> timeLabel("time");
+    static constexpr IndexedName<nDepth1> innerFeedLabel("innerFeed");
+    static constexpr IndexedName<nDepth1> d1FeedLabel("d1Feed");
     for (size_t idx = 0; idx < nDepth1; ++idx) {
-      auto indexStr = std::to_string(idx);
       value[ID::time0 + idx] = std::make_unique<LogValue>(
-        Scales::time.invmap(0.1), Scales::time, (timeLabel + indexStr).c_str(),
+        Scales::time.invmap(0.1), Scales::time, timeLabel[idx],
         kParameterIsAutomable | kParameterIsLogarithmic);
       value[ID::innerFeed0 + idx] = std::make_unique<LinearValue>(
-        0.5, Scales::feed, (innerFeedLabel + indexStr).c_str(), kParameterIsAutomable);
+        0.5, Scales::feed, innerFeedLabel[idx], kParameterIsAutomable);
       value[ID::d1Feed0 + idx] = std::make_unique<LinearValue>(
-        0.5, Scales::feed, (d1FeedLabel + indexStr).c_str(), kParameterIsAutomable);
+        0.5, Scales::feed, d1FeedLabel[idx], kParameterIsAutomable);
     }
 
-    std::string d2FeedLabel("d2Feed");
+    static constexpr IndexedName<nDepth2> d2FeedLabel("d2Feed");
     for (size_t idx = 0; idx < nDepth2; ++idx) {
-      auto indexStr = std::to_string(idx);
       value[ID::d2Feed0 + idx] = std::make_unique<LinearValue>(
-        0.5, Scales::feed, (d2FeedLabel + indexStr).c_str(), kParameterIsAutomable);
+        0.5, Scales::feed, d2FeedLabel[idx], kParameterIsAutomable);
     }
 
-    std::string d3FeedLabel("d3Feed");
+    static constexpr IndexedName<nDepth3> d3FeedLabel("d3Feed");
     for (size_t idx = 0; idx < nDepth3; ++idx) {
-      auto indexStr = std::to_string(idx);
       value[ID::d3Feed0 + idx] = std::make_unique<LinearValue>(
-        0.5, Scales::feed, (d3FeedLabel + indexStr).c_str(), kParameterIsAutomable);
+        0.5, Scales::feed, d3FeedLabel[idx], kParameterIsAutomable);
     }
 
-    std::string d4FeedLabel("d4Feed");
+    static constexpr IndexedName<nDepth4> d4FeedLabel("d4Feed");
     for (size_t idx = 0; idx < nDepth4; ++idx) {
-      auto indexStr = std::to_string(idx);
       value[ID::d4Feed0 + idx] = std::make_unique<LinearValue>(
-        0.5, Scales::feed, (d4FeedLabel + indexStr).c_str(), kParameterIsAutomable);
+        0.5, Scales::feed, d4FeedLabel[idx], kParameterIsAutomable);
     }
 
     value[ID::timeMultiply] = std::make_unique<LogValue>(
@@ -199,6 +196,9 @@ struct GlobalParameter : public ParameterInterface {
       0.5, Scales::smoothness, "smoothness", kParameterIsAutomable);
     value[ID::bypass] = std::make_unique<IntValue>(
       0, Scales::boolScale, "bypass", kParameterIsAutomable | kParameterIsBoolean);
+
+    value[ID::presetMorphTime] = std::make_unique<LogValue>(
+      0.0, Scales::presetMorphTime, "presetMorphTime", kParameterIsAutomable);
   }
 
 #ifndef TEST_BUILD
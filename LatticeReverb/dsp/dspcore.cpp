@@ -97,7 +97,8 @@ void DSPCORE_NAME::setParameters(float tempo)
 {
   using ID = ParameterID::ID;
 
-  SmootherCommon<float>::setTime(param.value[ID::smoothness]->getFloat());
+  SmootherCommon<float>::setTime(
+    morph.getSmoothingTime(param.value[ID::smoothness]->getFloat(), sampleRate));
 
   auto timeMul = param.value[ID::timeMultiply]->getFloat();
   auto outerMul = param.value[ID::outerFeedMultiply]->getFloat();
@@ -148,6 +149,7 @@ void DSPCORE_NAME::process(
   const size_t length, const float *in0, const float *in1, float *out0, float *out1)
 {
   SmootherCommon<float>::setBufferSize(length);
+  morph.process(length);
 
   for (size_t i = 0; i < length; ++i) {
     for (size_t idx = 0; idx < nestingDepth; ++idx) {
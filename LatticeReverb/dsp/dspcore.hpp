@@ -19,6 +19,7 @@
 
 #include "../../common/dsp/constants.hpp"
 #include "../../common/dsp/smoother.hpp"
+#include "../../common/presetmorph.hpp"
 #include "../parameter.hpp"
 
 #include "delay.hpp"
@@ -34,6 +35,7 @@ public:
 
   static const size_t maxVoice = 32;
   GlobalParameter param;
+  PresetMorph morph;
 
   virtual void setup(double sampleRate) = 0;
   virtual void reset() = 0;   // Stop sounds.
@@ -31,3 +31,4 @@ LogScale<double> Scales::timeLfoLowpas(0.0, 1.0, 0.5, 0.2);
 LinearScale<double> Scales::stereoCross(0.0, 0.5);
 LogScale<double> Scales::gain(0.0, 4.0, 0.5, 1.0);
 LogScale<double> Scales::smoothness(0.0, 8.0, 0.5, 1.0);
+LogScale<double> Scales::presetMorphTime(0.0, 10.0, 0.5, 1.0);
@@ -65,6 +65,8 @@ enum ID {
   smoothness,
   bypass,
 
+  presetMorphTime,
+
   ID_ENUM_LENGTH,
 };
 } // namespace ParameterID
@@ -81,57 +83,50 @@ struct Scales {
   static SomeDSP::LinearScale<double> stereoCross;
   static SomeDSP::LogScale<double> gain;
   static SomeDSP::LogScale<double> smoothness;
+  static SomeDSP::LogScale<double> presetMorphTime;
 };
 
 struct GlobalParameter : public ParameterInterface {
-  std::vector<std::unique_ptr<ValueInterface>> value;
+  ParameterStore<ParameterID::ID_ENUM_LENGTH> value;
 
   GlobalParameter()
   {
-    value.resize(ParameterID::ID_ENUM_LENGTH);
-
     using ID = ParameterID::ID;
     using LinearValue = FloatValue<SomeDSP::LinearScale<double>>;
     using LogValue = FloatValue<SomeDSP::LogScale<double>>;
 
-    std::string timeLabel("time");
-    std::string outerFeedLabel("outerFeed");
-    std::string innerFeedLabel("innerFeed");
+    static constexpr IndexedName<nestingDepth> timeLabel("time");
+    static constexpr IndexedName<nestingDepth> outerFeedLabel("outerFeed");
+    static constexpr IndexedName<nestingDepth> innerFeedLabel("innerFeed");
 
-    std::string timeOffsetLabel("timeOffset");
-    std::string outerFeedOffsetLabel("outerFeedOffset");
-    std::string innerFeedOffsetLabel("innerFeedOffset");
+    static constexpr IndexedName<nestingDepth> timeOffsetLabel("timeOffset");
+    static constexpr IndexedName<nestingDepth> outerFeedOffsetLabel("outerFeedOffset");
+    static constexpr IndexedName<nestingDepth> innerFeedOffsetLabel("innerFeedOffset");
 
-    std::string timeLfoAmountLabel("timeLfoAmount");
-    std::string lowpassCutoffLabel("lowpassCutoff");
+    static constexpr IndexedName<nestingDepth> timeLfoAmountLabel("timeLfoAmount");
+    static constexpr IndexedName<nestingDepth> lowpassCutoffLabel("lowpassCutoff");
 
     for (size_t idx = 0; idx < nestingDepth; ++idx) {
-      auto indexStr = std::to_string(idx);
       value[ID::time0 + idx] = std::make_unique<LogValue>(
-        Scales::time.invmap(0.1), Scales::time, (timeLabel + indexStr).c_str(),
+        Scales::time.invmap(0.1), Scales::time, timeLabel[idx],
         kParameterIsAutomable | kParameterIsLogarithmic);
       value[ID::outerFeed0 + idx] = std::make_unique<LinearValue>(
-        0.5, Scales::feed, (outerFeedLabel + indexStr).c_str(), kParameterIsAutomable);
+        0.5, Scales::feed, outerFeedLabel[idx], kParameterIsAutomable);
       value[ID::innerFeed0 + idx] = std::make_unique<LinearValue>(
-        0.5, Scales::feed, (innerFeedLabel + indexStr).c_str(), kParameterIsAutomable);
+        0.5, Scales::feed, innerFeedLabel[idx], kParameterIsAutomable);
 
       value[ID::timeOffset0 + idx] = std::make_unique<LinearValue>(
-        0.5, Scales::timeOffset, (timeOffsetLabel + indexStr).c_str(),
-        kParameterIsAutomable);
+        0.5, Scales::timeOffset, timeOffsetLabel[idx], kParameterIsAutomable);
       value[ID::outerFeedOffset0 + idx] = std::make_unique<LinearValue>(
-        0.5, Scales::feedOffset, (outerFeedOffsetLabel + indexStr).c_str(),
-        kParameterIsAutomable);
+        0.5, Scales::feedOffset, outerFeedOffsetLabel[idx], kParameterIsAutomable);
       value[ID::innerFeedOffset0 + idx] = std::make_unique<LinearValue>(
-        0.5, Scales::feedOffset, (innerFeedOffsetLabel + indexStr).c_str(),
-        kParameterIsAutomable);
+        0.5, Scales::feedOffset, innerFeedOffsetLabel[idx], kParameterIsAutomable);
 
       value[ID::timeLfoAmount0 + idx] = std::make_unique<LogValue>(
-        0.0, Scales::time, (timeLfoAmountLabel + indexStr).c_str(),
-        kParameterIsAutomable);
+        0.0, Scales::time, timeLfoAmountLabel[idx], kParameterIsAutomable);
 
       value[ID::lowpassCutoff0 + idx] = std::make_unique<LinearValue>(
-        1.0, Scales::defaultScale, (lowpassCutoffLabel + indexStr).c_str(),
-        kParameterIsAutomable);
+        1.0, Scales::defaultScale, lowpassCutoffLabel[idx], kParameterIsAutomable);
     }
 
     value[ID::timeMultiply] = std::make_unique<LinearValue>(
@@ -166,6 +161,9 @@ struct GlobalParameter : public ParameterInterface {
       0.5, Scales::smoothness, "smoothness", kParameterIsAutomable);
     value[ID::bypass] = std::make_unique<IntValue>(
       0, Scales::boolScale, "bypass", kParameterIsAutomable | kParameterIsBoolean);
+
+    value[ID::presetMorphTime] = std::make_unique<LogValue>(
+      0.0, Scales::presetMorphTime, "presetMorphTime", kParameterIsAutomable);
   }
 
 #ifndef TEST_BUILD
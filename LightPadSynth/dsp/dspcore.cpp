@@ -41,6 +41,12 @@
 
 constexpr float delayMaxTime = 1.0f;
 
+// Range of MPE timbre (CC 74) applied to filter cutoff, in octaves.
+constexpr float timbreCutoffOctave = 4.0f;
+
+// Release time of notes dropped by CPU governor. In seconds.
+constexpr float governorFadeTime = 0.02f;
+
 inline float clamp(float value, float min, float max)
 {
   return (value < min) ? min : (value > max) ? max : value;
@@ -81,7 +87,7 @@ void NOTE_NAME::noteOn(
   float pan,
   float phase,
   float sampleRate,
-  Wavetable &wavetable,
+  const Wavetable &wavetable,
   NoteProcessInfo &info,
   GlobalParameter &param)
 {
@@ -89,8 +95,10 @@ void NOTE_NAME::noteOn(
 
   state = NoteState::active;
   id = noteId;
+  isFading = false;
 
   this->velocity = velocity;
+  this->notePitch = notePitch;
   this->pan = pan;
   gain = 1.0f;
 
@@ -98,7 +106,6 @@ void NOTE_NAME::noteOn(
     notePitch + info.masterPitch.getValue(), info.equalTemperament.getValue(),
     info.pitchA4Hz.getValue());
 
-  // wavetable.refreshTable(noteFreq, osc.table);
   osc.setFrequency(notePitch, noteFreq, wavetable.tableBaseFreq, wavetable.tableSize);
 
   if (param.value[ID::oscPhaseReset]->getInt()) {
@@ -125,16 +132,44 @@ void NOTE_NAME::noteOn(
     param.value[ID::filterD]->getFloat(), param.value[ID::filterS]->getFloat(),
     param.value[ID::filterR]->getFloat(), noteFreq);
   delayGate.reset(sampleRate, param.value[ID::delayAttack]->getFloat(), noteFreq);
+
+  setExpression(NoteExpression(), info.equalTemperament.getValue(), true);
 }
 
 void NOTE_NAME::release()
 {
-  if (state == NoteState::rest) return;
+  if (state == NoteState::rest || isFading) return;
   state = NoteState::release;
   gainEnvelope.release();
   filterEnvelope.release();
 }
 
+void NOTE_NAME::release(float sampleRate, float seconds)
+{
+  if (state == NoteState::rest) return;
+  state = NoteState::release;
+  isFading = true;
+  gainEnvelope.release(sampleRate, seconds);
+  filterEnvelope.release();
+}
+
+void NOTE_NAME::setExpression(
+  const NoteExpression &expression, float equalTemperament, bool reset)
+{
+  const float ratio = powf(2.0f, expression.bend / equalTemperament);
+  const float timbre = powf(2.0f, timbreCutoffOctave * expression.timbre);
+  if (reset) {
+    bendRatio.reset(ratio);
+    pressure.reset(expression.pressure);
+    timbreRatio.reset(timbre);
+  }
+  bendRatio.push(ratio);
+  pressure.push(expression.pressure);
+  timbreRatio.push(timbre);
+
+  osc.setTableIndex(notePitch + expression.bend);
+}
+
 void NOTE_NAME::rest() { state = NoteState::rest; }
 
 bool NOTE_NAME::isAttacking() { return gainEnvelope.isAttacking(); }
@@ -142,17 +177,19 @@ bool NOTE_NAME::isAttacking() { return gainEnvelope.isAttacking(); }
 float NOTE_NAME::getGain() { return gain; }
 
 std::array<float, 2>
-NOTE_NAME::process(float sampleRate, Wavetable &wavetable, NoteProcessInfo &info)
+NOTE_NAME::process(float sampleRate, const Wavetable &wavetable, NoteProcessInfo &info)
 {
-  gain = velocity * gainEnvelope.process();
+  gain = velocity * gainEnvelope.process() * (1.0f + pressure.process());
   if (gainEnvelope.isTerminated()) state = NoteState::rest;
 
-  const auto oscOut = osc.process(wavetable.table, wavetable.tableSize);
+  const auto oscOut
+    = osc.process(wavetable.table, wavetable.tableSize, bendRatio.process());
 
   const auto cutAmt = info.filterAmount.getValue();
   const auto cutoff = std::clamp(
-    info.filterCutoff.getValue() + info.filterKeyFollow.getValue() * noteFreq
-      + mapCutoff(cutAmt * filterEnvelope.process()),
+    timbreRatio.process()
+      * (info.filterCutoff.getValue() + info.filterKeyFollow.getValue() * noteFreq
+         + mapCutoff(cutAmt * filterEnvelope.process())),
     0.0f, 22000.0f);
   const auto filterOut
     = filter.process(oscOut, sampleRate, cutoff, info.filterResonance.getValue());
@@ -173,8 +210,6 @@ DSPCORE_NAME::DSPCORE_NAME()
   unisonPan.reserve(maxVoice);
   noteIndices.reserve(maxVoice);
   voiceIndices.reserve(maxVoice);
-
-  peakInfos.resize(nOvertone);
 }
 
 void DSPCORE_NAME::setup(double sampleRate)
@@ -191,6 +226,8 @@ void DSPCORE_NAME::setup(double sampleRate)
 
   startup();
   prepareRefresh = true;
+
+  param.value.markChanged();
 }
 
 void DSPCORE_NAME::reset()
@@ -198,6 +235,8 @@ void DSPCORE_NAME::reset()
   for (auto &note : notes) note.rest();
   info.reset();
   startup();
+
+  param.value.markChanged();
 }
 
 void DSPCORE_NAME::startup() { info.rng.seed(param.value[ParameterID::seed]->getInt()); }
@@ -206,6 +245,12 @@ void DSPCORE_NAME::setParameters(float tempo)
 {
   using ID = ParameterID::ID;
 
+  param.value.consumeChanged();
+
+  // Playing notes can't follow the change of table size.
+  const auto tableSize = tableWorker.get()->tableSize;
+  if (tableWorker.receive() && tableWorker.get()->tableSize != tableSize) reset();
+
   SmootherCommon<float>::setTime(param.value[ID::smoothness]->getFloat());
 
   interpMasterGain.push(param.value[ID::gain]->getFloat());
@@ -241,24 +286,52 @@ void DSPCORE_NAME::setParameters(float tempo)
   nVoice = 16 * (param.value[ID::nVoice]->getInt() + 1);
   if (nVoice > notes.size()) nVoice = notes.size();
 
+  const auto governorLevel = param.value[ID::cpuGovernorLevel]->getInt();
+  if (governorLevel > 0) {
+    nVoice = std::max<size_t>(nVoice >> governorLevel, 16);
+    fadeOutExcessNotes();
+  }
+
+  // Envelope times take a few `pow` per note. Note frequency is fixed at note-on, so they
+  // are only recomputed when the envelope parameters are changed.
+  const bool isGainEnvelopeChanged = param.value.isChanged(ID::gainA, ID::gainCurve);
+  const bool isFilterEnvelopeChanged = param.value.isChanged(ID::filterA, ID::filterR);
+  const bool isDelayAttackChanged = param.value.isChanged(ID::delayAttack);
+
   for (auto &note : notes) {
     if (note.state == NoteState::rest) continue;
-    note.gainEnvelope.set(
-      sampleRate, param.value[ID::gainA]->getFloat(), param.value[ID::gainD]->getFloat(),
-      param.value[ID::gainS]->getFloat(), param.value[ID::gainR]->getFloat(),
-      param.value[ID::gainCurve]->getFloat(), note.noteFreq);
-    note.filterEnvelope.set(
-      sampleRate, param.value[ID::filterA]->getFloat(),
-      param.value[ID::filterD]->getFloat(), param.value[ID::filterS]->getFloat(),
-      param.value[ID::filterR]->getFloat(), note.noteFreq);
-    note.delayGate.atk.set(sampleRate, param.value[ID::delayAttack]->getFloat());
+    if (!note.isFading && isGainEnvelopeChanged) {
+      note.gainEnvelope.set(
+        sampleRate, param.value[ID::gainA]->getFloat(),
+        param.value[ID::gainD]->getFloat(), param.value[ID::gainS]->getFloat(),
+        param.value[ID::gainR]->getFloat(), param.value[ID::gainCurve]->getFloat(),
+        note.noteFreq);
+    } else if (!note.isFading) {
+      note.gainEnvelope.setSustain(param.value[ID::gainS]->getFloat());
+    }
+
+    if (isFilterEnvelopeChanged) {
+      note.filterEnvelope.set(
+        sampleRate, param.value[ID::filterA]->getFloat(),
+        param.value[ID::filterD]->getFloat(), param.value[ID::filterS]->getFloat(),
+        param.value[ID::filterR]->getFloat(), note.noteFreq);
+    } else {
+      note.filterEnvelope.setSustain(param.value[ID::filterS]->getFloat());
+    }
+
+    if (isDelayAttackChanged)
+      note.delayGate.atk.set(sampleRate, param.value[ID::delayAttack]->getFloat());
   }
 
-  if (prepareRefresh || (!isLFORefreshed && param.value[ID::refreshLFO]->getInt()))
+  if (
+    isLfoRefreshRequested.exchange(false) || prepareRefresh
+    || (!isLFORefreshed && param.value[ID::refreshLFO]->getInt()))
     refreshLfo();
   isLFORefreshed = param.value[ID::refreshLFO]->getInt();
 
-  if (prepareRefresh || (!isTableRefeshed && param.value[ID::refreshTable]->getInt()))
+  if (
+    isTableRefreshRequested.exchange(false) || prepareRefresh || isTableRequestPending
+    || (!isTableRefeshed && param.value[ID::refreshTable]->getInt()))
     refreshTable();
   isTableRefeshed = param.value[ID::refreshTable]->getInt();
 
@@ -279,7 +352,7 @@ void DSPCORE_NAME::process(const size_t length, float *out0, float *out1)
 
     for (auto &note : notes) {
       if (note.state == NoteState::rest) continue;
-      auto sig = note.process(sampleRate, wavetable, info);
+      auto sig = note.process(sampleRate, *tableWorker.get(), info);
       frame[0] += sig[0];
       frame[1] += sig[1];
     }
@@ -413,15 +486,24 @@ void DSPCORE_NAME::noteOn(int32_t identifier, int16_t pitch, float tuning, float
 {
   using ID = ParameterID::ID;
 
-  const size_t nUnison = 1 + param.value[ID::nUnison]->getInt();
+  // CPU governor halves unison for each level.
+  const auto governorLevel = param.value[ID::cpuGovernorLevel]->getInt();
+  const size_t nUnison
+    = std::max<size_t>((1 + param.value[ID::nUnison]->getInt()) >> governorLevel, 1);
 
   noteIndices.resize(0);
 
+  // Reuse note of same ID. This happens when a key held by pedal is struck again.
+  for (size_t index = 0; index < nVoice; ++index) {
+    if (noteIndices.size() >= nUnison) break;
+    if (notes[index].id == identifier && notes[index].state != NoteState::rest)
+      noteIndices.push_back(index);
+  }
+
   // Pick up note from resting one.
   for (size_t index = 0; index < nVoice; ++index) {
-    if (notes[index].id == identifier) noteIndices.push_back(index);
-    if (notes[index].state == NoteState::rest) noteIndices.push_back(index);
     if (noteIndices.size() >= nUnison) break;
+    if (notes[index].state == NoteState::rest) noteIndices.push_back(index);
   }
 
   // If there aren't enought resting note, pick up from most quiet one.
@@ -433,6 +515,8 @@ void DSPCORE_NAME::noteOn(int32_t identifier, int16_t pitch, float tuning, float
     });
 
     for (auto &index : voiceIndices) {
+      if (notes[index].state == NoteState::rest) continue;
+      if (notes[index].id == identifier) continue;
       fillTransitionBuffer(index);
       noteIndices.push_back(index);
       if (noteIndices.size() >= nUnison) break;
@@ -441,8 +525,8 @@ void DSPCORE_NAME::noteOn(int32_t identifier, int16_t pitch, float tuning, float
 
   if (nUnison <= 1) {
     notes[noteIndices[0]].noteOn(
-      identifier, float(pitch) + tuning, velocity, 0.5f, 0.0f, sampleRate, wavetable,
-      info, param);
+      identifier, float(pitch) + tuning, velocity, 0.5f, 0.0f, sampleRate,
+      *tableWorker.get(), info, param);
     return;
   }
 
@@ -461,7 +545,7 @@ void DSPCORE_NAME::noteOn(int32_t identifier, int16_t pitch, float tuning, float
     auto phase = unisonPhase * unison / float(nUnison);
     notes[noteIndices[unison]].noteOn(
       identifier, notePitch, distGain(info.rng) * velocity, unisonPan[unison], phase,
-      sampleRate, wavetable, info, param);
+      sampleRate, *tableWorker.get(), info, param);
   }
 }
 
@@ -482,7 +566,7 @@ void DSPCORE_NAME::fillTransitionBuffer(size_t noteIndex)
       break;
     }
 
-    auto oscOut = note.process(sampleRate, wavetable, info);
+    auto oscOut = note.process(sampleRate, *tableWorker.get(), info);
     auto idx = (trIndex + bufIdx) % transitionBuffer.size();
     auto interp = 1.0f - float(bufIdx) / transitionBuffer.size();
 
@@ -491,24 +575,73 @@ void DSPCORE_NAME::fillTransitionBuffer(size_t noteIndex)
   }
 }
 
+// Fades out the quietest notes until the number of sounding notes fits in nVoice.
+void DSPCORE_NAME::fadeOutExcessNotes()
+{
+  size_t nSounding = 0;
+  for (auto &note : notes) {
+    if (note.state != NoteState::rest && !note.isFading) ++nSounding;
+  }
+
+  for (; nSounding > nVoice; --nSounding) {
+    size_t target = notes.size();
+    for (size_t idx = 0; idx < notes.size(); ++idx) {
+      auto &note = notes[idx];
+      if (note.state == NoteState::rest || note.isFading) continue;
+      if (
+        target >= notes.size()
+        || (!note.isAttacking() && note.getGain() < notes[target].getGain()))
+        target = idx;
+    }
+    notes[target].release(sampleRate, governorFadeTime);
+  }
+}
+
 void DSPCORE_NAME::noteOff(int32_t noteId)
 {
   for (size_t i = 0; i < notes.size(); ++i)
     if (notes[i].id == noteId) notes[i].release();
 }
 
+void DSPCORE_NAME::setNoteExpression(int32_t noteId, NoteExpression expression)
+{
+  // Notes which are not yet started in this cycle.
+  for (auto &nt : midiNotes) {
+    if (nt.isNoteOn && nt.id == noteId) nt.expression = expression;
+  }
+  applyNoteExpression(noteId, expression, false);
+}
+
+void DSPCORE_NAME::applyNoteExpression(
+  int32_t noteId, const NoteExpression &expression, bool reset)
+{
+  const float equalTemperament = info.equalTemperament.getValue();
+  for (auto &note : notes) {
+    if (note.id == noteId && note.state != NoteState::rest)
+      note.setExpression(expression, equalTemperament, reset);
+  }
+}
+
 void DSPCORE_NAME::refreshTable()
 {
   using ID = ParameterID::ID;
 
-  reset();
+  // Table is deterministic. Skip when it's already made from the same parameters, as
+  // refresh is requested several times on restoring a session.
+  auto &value = param.value;
+  auto key = StateSnapshot::hash(value, ID::overtoneGain0, ID::lfoWavetable0 - 1);
+  key = StateSnapshot::hash(value, ID::tableBaseFrequency, ID::uniformPhaseProfile, key);
+  key = StateSnapshot::hashBytes(sampleRate, key);
+  if (key == tableKey) return;
 
+  auto &req = tableRequest;
   const float tableBaseFreq = param.value[ID::tableBaseFrequency]->getFloat();
   const float pitchMultiplier = param.value[ID::overtonePitchMultiply]->getFloat();
   const float pitchModulo = param.value[ID::overtonePitchModulo]->getFloat();
   const float gainPow = param.value[ID::overtoneGainPower]->getFloat();
   const float widthMul = param.value[ID::overtoneWidthMultiply]->getFloat();
 
+  auto &peakInfos = req.peakInfos;
   for (size_t idx = 0; idx < peakInfos.size(); ++idx) {
     peakInfos[idx].frequency = (pitchMultiplier * idx + 1.0f) * tableBaseFreq
       * param.value[ID::overtonePitch0 + idx]->getFloat();
@@ -525,14 +658,22 @@ void DSPCORE_NAME::refreshTable()
 
   size_t bufferSize = param.value[ID::tableBufferSize]->getInt();
   if (bufferSize >= 12) bufferSize = 11;
-  wavetable.resize(1024 << bufferSize);
-
-  wavetable.padsynth(
-    sampleRate, tableBaseFreq, peakInfos, param.value[ID::padSynthSeed]->getInt(),
-    param.value[ID::spectrumExpand]->getFloat(),
-    param.value[ID::spectrumRotate]->getFloat(),
-    param.value[ID::profileComb]->getInt() + 1, param.value[ID::profileShape]->getFloat(),
-    param.value[ID::uniformPhaseProfile]->getInt());
+
+  req.sampleRate = sampleRate;
+  req.tableBaseFreq = tableBaseFreq;
+  req.tableSize = minTableSize << bufferSize;
+  req.seed = param.value[ID::padSynthSeed]->getInt();
+  req.expand = param.value[ID::spectrumExpand]->getFloat();
+  req.rotate = param.value[ID::spectrumRotate]->getFloat();
+  req.profileSkip = param.value[ID::profileComb]->getInt() + 1;
+  req.profileShape = param.value[ID::profileShape]->getFloat();
+  req.uniformPhaseProfile = param.value[ID::uniformPhaseProfile]->getInt();
+  req.key = key;
+
+  // Table is built on `tableWorker` thread, and notes keep playing the previous table
+  // until it's done. The worker may be holding its lock, then retry on next cycle.
+  isTableRequestPending = !tableWorker.request(req);
+  if (!isTableRequestPending) tableKey = key;
 }
 
 void DSPCORE_NAME::refreshLfo()
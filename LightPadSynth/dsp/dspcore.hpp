@@ -19,15 +19,20 @@
 
 #include "../../common/dsp/constants.hpp"
 #include "../../common/dsp/smoother.hpp"
+#include "../../common/midi.hpp"
+#include "../../common/snapshot.hpp"
+#include "../../common/tableworker.hpp"
 #include "../parameter.hpp"
 #include "delay.hpp"
 #include "envelope.hpp"
 #include "oscillator.hpp"
 
 #include <array>
+#include <atomic>
 #include <cmath>
 #include <memory>
 #include <random>
+#include <string>
 
 using namespace SomeDSP;
 
@@ -107,9 +112,11 @@ struct NoteProcessInfo {
                                                                                          \
     int32_t id = -1;                                                                     \
     float velocity = 0;                                                                  \
+    float notePitch = 0;                                                                 \
     float noteFreq = 1;                                                                  \
     float pan = 0.5f;                                                                    \
     float gain = 0;                                                                      \
+    bool isFading = false;                                                               \
                                                                                          \
     ExpADSREnvelope<float> gainEnvelope;                                                 \
     LinearADSREnvelope<float> filterEnvelope;                                            \
@@ -119,6 +126,10 @@ struct NoteProcessInfo {
     Delay<float> delay;                                                                  \
     float delaySeconds = 0;                                                              \
                                                                                          \
+    ExpSmoother<float> bendRatio;                                                        \
+    ExpSmoother<float> pressure;                                                         \
+    ExpSmoother<float> timbreRatio;                                                      \
+                                                                                         \
     void setup(float sampleRate);                                                        \
     void noteOn(                                                                         \
       int32_t noteId,                                                                    \
@@ -127,16 +138,18 @@ struct NoteProcessInfo {
       float pan,                                                                         \
       float phase,                                                                       \
       float sampleRate,                                                                  \
-      Wavetable &wavetable,                                                              \
+      const Wavetable &wavetable,                                                        \
       NoteProcessInfo &info,                                                             \
       GlobalParameter &param);                                                           \
     void release();                                                                      \
-    void release(float seconds);                                                         \
+    void release(float sampleRate, float seconds);                                       \
+    void setExpression(                                                                  \
+      const NoteExpression &expression, float equalTemperament, bool reset);             \
     void rest();                                                                         \
     bool isAttacking();                                                                  \
     float getGain();                                                                     \
     std::array<float, 2>                                                                 \
-    process(float sampleRate, Wavetable &wavetable, NoteProcessInfo &info);              \
+    process(float sampleRate, const Wavetable &wavetable, NoteProcessInfo &info);        \
   };
 
 NOTE_CLASS(AVX512)
@@ -151,6 +164,10 @@ public:
   static const size_t maxVoice = 128;
   GlobalParameter param;
 
+  // Set by `request*Refresh()`, and taken by `setParameters()`.
+  std::atomic<bool> isTableRefreshRequested{false};
+  std::atomic<bool> isLfoRefreshRequested{false};
+
   virtual void setup(double sampleRate) = 0;
   virtual void reset() = 0;   // Stop sounds.
   virtual void startup() = 0; // Reset phase, random seed etc.
@@ -158,9 +175,18 @@ public:
   virtual void process(const size_t length, float *out0, float *out1) = 0;
   virtual void noteOn(int32_t noteId, int16_t pitch, float tuning, float velocity) = 0;
   virtual void noteOff(int32_t noteId) = 0;
+  virtual void setNoteExpression(int32_t noteId, NoteExpression expression) = 0;
   virtual void refreshTable() = 0;
   virtual void refreshLfo() = 0;
 
+  // Empty string disables on-disk table cache.
+  virtual void setTableCacheDirectory(const std::string &directory) = 0;
+
+  // Host thread. Defers the refresh to next `setParameters()` on audio thread. Wavetable
+  // is then built on the table worker, so host thread doesn't wait for it.
+  void requestTableRefresh() { isTableRefreshRequested.store(true); }
+  void requestLfoRefresh() { isLfoRefreshRequested.store(true); }
+
   struct MidiNote {
     bool isNoteOn;
     uint32_t frame;
@@ -168,6 +194,7 @@ public:
     int16_t pitch;
     float tuning;
     float velocity;
+    NoteExpression expression;
   };
 
   std::vector<MidiNote> midiNotes;
@@ -196,7 +223,12 @@ public:
     void noteOn(int32_t noteId, int16_t pitch, float tuning, float velocity) override;   \
     void fillTransitionBuffer(size_t noteIndex);                                         \
     void noteOff(int32_t noteId) override;                                               \
+    void setNoteExpression(int32_t noteId, NoteExpression expression) override;          \
     void refreshTable() override;                                                        \
+    void setTableCacheDirectory(const std::string &directory) override                   \
+    {                                                                                    \
+      tableWorker.setCacheDirectory(directory);                                          \
+    }                                                                                    \
     void refreshLfo() override;                                                          \
                                                                                          \
     void pushMidiNote(                                                                   \
@@ -225,25 +257,34 @@ public:
               return nt.frame == frame;                                                  \
             });                                                                          \
         if (it == std::end(midiNotes)) return;                                           \
-        if (it->isNoteOn)                                                                \
+        if (it->isNoteOn) {                                                              \
           noteOn(it->id, it->pitch, it->tuning, it->velocity);                           \
-        else                                                                             \
+          applyNoteExpression(it->id, it->expression, true);                             \
+        } else {                                                                         \
           noteOff(it->id);                                                               \
+        }                                                                                \
         midiNotes.erase(it);                                                             \
       }                                                                                  \
     }                                                                                    \
                                                                                          \
   private:                                                                               \
+    void applyNoteExpression(                                                            \
+      int32_t noteId, const NoteExpression &expression, bool reset);                     \
     void setUnisonPan(size_t nUnison);                                                   \
+    void fadeOutExcessNotes();                                                           \
                                                                                          \
     float sampleRate = 44100.0f;                                                         \
                                                                                          \
-    std::vector<PeakInfo<float>> peakInfos;                                              \
+    WavetableRequest tableRequest{nOvertone, std::make_shared<PadSynth>()};              \
                                                                                          \
     bool prepareRefresh = true;                                                          \
     bool isTableRefeshed = false;                                                        \
+    bool isTableRequestPending = false;                                                  \
     bool isLFORefreshed = false;                                                         \
-    Wavetable wavetable;                                                                 \
+    uint64_t tableKey = 0;                                                               \
+    TableWorker<SharedWavetable, WavetableRequest> tableWorker{                          \
+      std::make_unique<SharedWavetable>(std::make_shared<Wavetable>(minTableSize)),      \
+      WavetableRequest(nOvertone)};                                                      \
     LfoWavetable<lfoTableSize> lfoWavetable;                                             \
                                                                                          \
     size_t nVoice = 32;                                                                  \
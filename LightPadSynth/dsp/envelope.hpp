@@ -161,6 +161,14 @@ public:
     rel.reset(sampleRate, adaptTime(releaseTime, noteFreq));
   }
 
+  // `sus` is `LinearSmoother`, so it must be pushed on every cycle. Call this instead of
+  // `set()` when the other parameters are not changed.
+  void setSustain(Sample sustainLevel)
+  {
+    if (state == State::release) return;
+    sus.push(std::clamp<Sample>(sustainLevel, Sample(0), Sample(1)));
+  }
+
   void set(
     Sample sampleRate,
     Sample attackTime,
@@ -201,6 +209,13 @@ public:
     state = State::release;
   }
 
+  // Release in `seconds` regardless of release time. Following `set()` must be skipped.
+  void release(Sample sampleRate, Sample seconds)
+  {
+    rel.reset(sampleRate, seconds);
+    release();
+  }
+
   void terminate()
   {
     value = 0;
@@ -279,6 +294,13 @@ public:
     set(sampleRate, attackTime, decayTime, sustainLevel, releaseTime, noteFreq);
   }
 
+  // `sus` is `LinearSmoother`, so it must be pushed on every cycle. Call this instead of
+  // `set()` when the other parameters are not changed.
+  void setSustain(Sample sustainLevel)
+  {
+    sus.push(std::clamp<Sample>(sustainLevel, Sample(0), Sample(1)));
+  }
+
   void set(
     Sample sampleRate,
     Sample attackTime,
@@ -287,7 +309,7 @@ public:
     Sample releaseTime,
     Sample noteFreq)
   {
-    sus.push(std::clamp<Sample>(sustainLevel, Sample(0), Sample(1)));
+    setSustain(sustainLevel);
     trimNoteFreq(noteFreq);
     atk = secondToDelta(sampleRate, adaptTime(attackTime, noteFreq));
     dec = secondToDelta(sampleRate, adaptTime(decayTime, noteFreq));
@@ -22,12 +22,17 @@
 
 #include "../../common/dsp/constants.hpp"
 #include "../../common/dsp/somemath.hpp"
+#include "../../common/tablecache.hpp"
+#include "../../common/tablefile.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <deque>
+#include <memory>
 #include <numeric>
 #include <random>
+#include <string>
 #include <vector>
 
 namespace SomeDSP {
@@ -94,10 +99,14 @@ public:
 };
 
 constexpr size_t initialTableSize = 262144;
-constexpr size_t maxMidiNoteNumber = 128;
+constexpr size_t minTableSize = 1024;
 
 /**
-Last element of table is padded for linear interpolation.
+`table` is octave spaced mip-map. `table[level]` has `tableSize >> level` samples, and
+only contains bins below its own Nyquist frequency. Each level represents the same
+signal at half the sampling rate of previous level, so total memory is about 2 tables.
+
+Last element of each level is padded for linear interpolation.
 For example, consider following table:
 
 ```
@@ -112,82 +121,144 @@ tablePadded = [11, 22, 33, 44, 11].
 ```
  */
 struct Wavetable {
-  std::vector<std::complex<float>> spectrum;
-  std::vector<std::complex<float>> tmpSpec;
   std::vector<std::vector<float>> table;
   float tableBaseFreq = 20.0f;
   size_t tableSize = initialTableSize;
-  PocketFFT<float> fft;
 
-  Wavetable() { resize(initialTableSize); }
+  Wavetable(size_t tableSize = initialTableSize) { resize(tableSize); }
 
+  // `tableSize` must be power of 2. Last level has 2 samples.
   void resize(size_t tableSize)
   {
     this->tableSize = tableSize;
 
-    size_t spectrumSize = tableSize / 2 + 1;
-    spectrum.resize(spectrumSize);
-    tmpSpec.resize(spectrumSize);
-
-    table.resize(maxMidiNoteNumber);
-    for (auto &tbl : table) tbl.resize(tableSize + 1);
-
-    pocketfft::shape_t shape{tableSize};
-    fft.setShape(shape);
+    size_t nLevel = 0;
+    while ((tableSize >> nLevel) > 2) ++nLevel;
+    table.resize(nLevel + 1);
+    for (size_t level = 0; level < table.size(); ++level)
+      table[level].resize((tableSize >> level) + 1);
   }
 
   size_t getTableSize() { return tableSize; }
 
-  inline float profile(float fi, float bwi, float shape)
+  // Layout of `TableFile`. `tableBaseFreq` followed by all the levels.
+  std::vector<TableFile::Chunk> getChunks() const
   {
-    if (bwi < 1e-5) bwi = 1e-5;
-    auto x = fi / bwi;
-    return powf(expf(-x * x) / bwi, shape);
+    std::vector<TableFile::Chunk> chunks{{&tableBaseFreq, 1}};
+    for (const auto &tbl : table) chunks.push_back({tbl.data(), tbl.size()});
+    return chunks;
   }
 
-  void padsynth(
-    float sampleRate,
-    float tableBaseFreq,
-    std::vector<PeakInfo<float>> &peakInfos,
-    uint32_t seed,
-    float expand,
-    float rotate,
-    uint32_t profileSkip, // 1 or greater.
-    float profileShape,
-    bool uniformPhaseProfile)
+  // Returns false when `file` is made for other table size.
+  bool load(const TableFile &file)
   {
-    if (profileSkip < 1) profileSkip = 1;
+    size_t nFloat = 1;
+    for (const auto &tbl : table) nFloat += tbl.size();
+    if (file.size() != nFloat) return false;
+
+    const float *src = file.data();
+    tableBaseFreq = *src++;
+    for (auto &tbl : table) {
+      std::copy_n(src, tbl.size(), tbl.begin());
+      src += tbl.size();
+    }
+    return true;
+  }
 
-    this->tableBaseFreq = tableBaseFreq;
+  // Inverse FFT is done in the size of level. `scale` compensates `1 / ndata` in
+  // `c2r()`, so all levels have the same amplitude.
+  void refreshTable(
+    const std::vector<std::complex<float>> &spectrum,
+    std::vector<std::complex<float>> &tmpSpec,
+    PocketFFT<float> &fft,
+    std::vector<float> &table)
+  {
+    const size_t levelSize = table.size() - 1;
+    const size_t bandIdx = levelSize / 2; // Nyquist bin of the level is excluded.
 
-    for (size_t bin = 1; bin < spectrum.size(); ++bin) spectrum[bin] = 0.0f;
+    std::copy_n(spectrum.begin(), bandIdx, tmpSpec.begin());
+    tmpSpec[bandIdx] = 0;
 
-    std::minstd_rand rng(seed);
-    for (const auto &peak : peakInfos) {
-      float bandHz = (powf(2.0f, peak.bandWidth / 1200.0f) - 1.0f) * peak.frequency;
-      float bandIdx = bandHz / (2.0f * sampleRate);
+    fft.setShape({levelSize});
+    fft.c2r(tmpSpec.data(), table.data(), false, float(levelSize) / tableSize);
 
-      float sigma = sqrtf(bandIdx * bandIdx / float(twopi));
-      int32_t profileHalf = std::max<int32_t>(1, int32_t(spectrum.size() * 5 * sigma));
+    // Fill padded elements.
+    table[levelSize] = table[0];
+  }
+};
 
-      float freqIdx = peak.frequency * 2.0f / sampleRate;
+// Built table is immutable, and shared between plugin instances by `TableCache`.
+using SharedWavetable = std::shared_ptr<const Wavetable>;
 
-      int32_t center = int32_t(freqIdx * spectrum.size());
-      int32_t start = std::max<int32_t>(center - profileHalf, 0);
-      int32_t end = std::min<int32_t>(center + profileHalf, int32_t(spectrum.size()));
+class PadSynth;
 
-      std::uniform_real_distribution<float> distPhase(0.0f, peak.phase);
-      auto phase = distPhase(rng);
-      for (int32_t bin = start; bin < end; bin += profileSkip) {
-        auto radius = peak.gain
-          * profile(bin / float(spectrum.size()) - freqIdx, bandIdx, profileShape);
-        if (!uniformPhaseProfile) phase = distPhase(rng);
-        spectrum[bin] += std::complex<float>(radius * cosf(phase), radius * sinf(phase));
-      }
-    }
+// Inputs of `PadSynth::build()`. `build()` is called on `TableWorker` thread.
+struct WavetableRequest {
+  uint64_t key = 0; // Hash of other members. Same key returns the same cached table.
+  float sampleRate = 44100.0f;
+  float tableBaseFreq = 20.0f;
+  size_t tableSize = initialTableSize;
+  std::vector<PeakInfo<float>> peakInfos; // Size is fixed at construction.
+  uint32_t seed = 0;
+  float expand = 1.0f;
+  float rotate = 0.0f;
+  uint32_t profileSkip = 1;
+  float profileShape = 1.0f;
+  bool uniformPhaseProfile = false;
+
+  // State of incremental update. Copies of a request share the same `PadSynth`.
+  std::shared_ptr<PadSynth> padsynth;
+
+  WavetableRequest(size_t nPeak = 0, std::shared_ptr<PadSynth> padsynth = nullptr)
+    : peakInfos(nPeak), padsynth(padsynth)
+  {
+  }
+
+  // `cacheDirectory` is the directory of `TableFile`. Empty disables it.
+  std::unique_ptr<SharedWavetable> build(const std::string &cacheDirectory) const;
+};
+
+// Seed of each peak is independent from other peaks, so a peak can be recomputed alone.
+// Mixing is the finalizer of splitmix64.
+inline uint32_t peakSeed(uint32_t seed, size_t index)
+{
+  uint64_t z = (uint64_t(seed) << 32) + index + 0x9e3779b97f4a7c15;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+  return uint32_t(z ^ (z >> 31));
+}
+
+/**
+PADsynth with incremental update. Only used on `TableWorker` thread.
+
+Sum of peak profiles is kept from the previous build. When a few peaks are changed, old
+contribution of those peaks is subtracted and new one is added, so `profile()` is only
+evaluated on their bins. Levels whose band limit is under the lowest changed bin are
+copied from the previous table instead of inverse FFT. Copied levels are rescaled,
+because normalization gain changes on every edit.
+
+Subtraction leaves float error, so the sum is rebuilt from scratch every
+`maxIncrementalUpdate` builds, or when a parameter other than peaks is changed.
+*/
+class PadSynth {
+public:
+  static constexpr size_t maxIncrementalUpdate = 64;
+
+  std::shared_ptr<Wavetable> build(const WavetableRequest &req)
+  {
+    auto wavetable = std::make_shared<Wavetable>(req.tableSize);
+    wavetable->tableBaseFreq = req.tableBaseFreq;
+
+    // Expand and rotate move bins, so changed range is unknown.
+    size_t lowestBin = accumulate(req);
+    if (req.expand != 1.0f || req.rotate != 0) lowestBin = 0;
+    if (req.expand != prev.expand || req.rotate != prev.rotate) lowestBin = 0;
+
+    std::vector<std::complex<float>> spectrum(peakSum);
+    std::vector<std::complex<float>> tmpSpec(spectrum.size());
 
-    if (expand != 1.0f || rotate != 0) {
-      size_t rot = size_t(fabs(rotate) * spectrum.size());
+    if (req.expand != 1.0f || req.rotate != 0) {
+      size_t rot = size_t(fabs(req.rotate) * spectrum.size());
       if (rot < spectrum.size()) {
         std::rotate_copy(
           spectrum.begin(), spectrum.begin() + rot, spectrum.end(), tmpSpec.begin());
@@ -197,7 +268,7 @@ struct Wavetable {
 
       size_t bin = 1;
       for (; bin < spectrum.size(); ++bin) {
-        float tmpIdx = (bin - 1) / expand;
+        float tmpIdx = (bin - 1) / req.expand;
         int32_t low = int32_t(tmpIdx) + 1;
         if (low >= int32_t(spectrum.size())) break;
         size_t high = low + 1;
@@ -212,47 +283,173 @@ struct Wavetable {
     spectrum[0] = 0.0f;
 
     // Normalize spectrum. Reference: https://dsp.stackexchange.com/a/3470
+    float divisor = 1.0f;
     float sum = 0;
     for (const auto &bin : spectrum) sum += abs(bin);
     if (sum != 0) {
-      sum = 0.5f * sum / tableSize;
-      for (auto &bin : spectrum) bin /= sum;
+      divisor = 0.5f * sum / req.tableSize;
+      for (auto &bin : spectrum) bin /= divisor;
     }
 
-    for (int i = 0; i < int(table.size()); ++i)
-      refreshTable(440.0 * pow(2.0, (i - 69) / 12.0), table[i]);
+    PocketFFT<float> fft;
+    const float gain = prevDivisor / divisor;
+    for (size_t level = 0; level < wavetable->table.size(); ++level) {
+      auto &tbl = wavetable->table[level];
+      if (tbl.size() - 1 > 2 * lowestBin) {
+        wavetable->refreshTable(spectrum, tmpSpec, fft, tbl);
+        continue;
+      }
+      const auto &src = prevTable->table[level];
+      std::transform(
+        src.begin(), src.end(), tbl.begin(), [&](float value) { return gain * value; });
+    }
+
+    prev = req;
+    prev.padsynth = nullptr;
+    prevTable = wavetable;
+    prevDivisor = divisor;
+    return wavetable;
+  }
+
+private:
+  static float profile(float fi, float bwi, float shape)
+  {
+    if (bwi < 1e-5) bwi = 1e-5;
+    auto x = fi / bwi;
+    return powf(expf(-x * x) / bwi, shape);
   }
 
-  void refreshTable(float frequency, std::vector<float> &table)
+  static bool isSamePeak(const PeakInfo<float> &a, const PeakInfo<float> &b)
   {
-    size_t bandIdx = size_t(spectrum.size() * tableBaseFreq / frequency);
-    bandIdx = std::clamp<size_t>(bandIdx, 1, spectrum.size());
+    return a.frequency == b.frequency && a.gain == b.gain && a.phase == b.phase
+      && a.bandWidth == b.bandWidth;
+  }
 
-    std::copy_n(spectrum.begin(), bandIdx, tmpSpec.begin());
-    std::fill(tmpSpec.begin() + bandIdx, tmpSpec.end(), 0);
+  // Returns the lowest bin which is changed from previous build.
+  size_t accumulate(const WavetableRequest &req)
+  {
+    const bool isSameShape = prevTable != nullptr && nUpdate < maxIncrementalUpdate
+      && req.sampleRate == prev.sampleRate && req.tableSize == prev.tableSize
+      && req.seed == prev.seed && req.profileSkip == prev.profileSkip
+      && req.profileShape == prev.profileShape
+      && req.uniformPhaseProfile == prev.uniformPhaseProfile
+      && req.peakInfos.size() == prev.peakInfos.size();
+
+    std::vector<size_t> changed;
+    if (isSameShape) {
+      for (size_t idx = 0; idx < req.peakInfos.size(); ++idx)
+        if (!isSamePeak(req.peakInfos[idx], prev.peakInfos[idx])) changed.push_back(idx);
+    }
 
-    fft.c2r(tmpSpec.data(), table.data());
+    // Incremental update costs 2 peaks for each changed peak.
+    if (!isSameShape || 2 * changed.size() > req.peakInfos.size()) {
+      peakSum.assign(req.tableSize / 2 + 1, 0);
+      for (size_t idx = 0; idx < req.peakInfos.size(); ++idx) addPeak(req, idx, 1.0f);
+      nUpdate = 0;
+      return 0;
+    }
 
-    // Fill padded elements.
-    table[table.size() - 1] = table[0];
+    size_t lowestBin = peakSum.size();
+    for (const auto &idx : changed) {
+      lowestBin = std::min(lowestBin, addPeak(prev, idx, -1.0f));
+      lowestBin = std::min(lowestBin, addPeak(req, idx, 1.0f));
+    }
+    ++nUpdate;
+    return lowestBin;
   }
+
+  // Returns the first bin of the peak.
+  size_t addPeak(const WavetableRequest &req, size_t index, float sign)
+  {
+    const auto &peak = req.peakInfos[index];
+    if (peak.gain == 0) return peakSum.size();
+
+    const int32_t size = int32_t(peakSum.size());
+    float bandHz = (powf(2.0f, peak.bandWidth / 1200.0f) - 1.0f) * peak.frequency;
+    float bandIdx = bandHz / (2.0f * req.sampleRate);
+
+    float sigma = sqrtf(bandIdx * bandIdx / float(twopi));
+    int32_t profileHalf = std::max<int32_t>(1, int32_t(size * 5 * sigma));
+
+    float freqIdx = peak.frequency * 2.0f / req.sampleRate;
+
+    int32_t center = int32_t(freqIdx * size);
+    int32_t start = std::max<int32_t>(center - profileHalf, 0);
+    int32_t end = std::min<int32_t>(center + profileHalf, size);
+    if (start >= end) return peakSum.size();
+
+    std::minstd_rand rng(peakSeed(req.seed, index));
+    std::uniform_real_distribution<float> distPhase(0.0f, peak.phase);
+    auto phase = distPhase(rng);
+    const int32_t skip = std::max<int32_t>(1, int32_t(req.profileSkip));
+    for (int32_t bin = start; bin < end; bin += skip) {
+      auto radius = sign * peak.gain
+        * profile(bin / float(size) - freqIdx, bandIdx, req.profileShape);
+      if (!req.uniformPhaseProfile) phase = distPhase(rng);
+      peakSum[bin] += std::complex<float>(radius * cosf(phase), radius * sinf(phase));
+    }
+    return size_t(start);
+  }
+
+  WavetableRequest prev;
+  std::vector<std::complex<float>> peakSum;
+  std::shared_ptr<const Wavetable> prevTable;
+  float prevDivisor = 1.0f;
+  size_t nUpdate = 0;
 };
 
+inline std::unique_ptr<SharedWavetable>
+WavetableRequest::build(const std::string &cacheDirectory) const
+{
+  auto table = TableCache<Wavetable>::instance().get(key, [&]() {
+    const auto path = TableFile::getPath(cacheDirectory, key);
+    auto wavetable = std::make_shared<Wavetable>(tableSize);
+    if (wavetable->load(TableFile(path, key))) return wavetable;
+
+    wavetable = padsynth ? padsynth->build(*this) : PadSynth().build(*this);
+    TableFile::write(path, key, wavetable->getChunks());
+    return wavetable;
+  });
+  return std::make_unique<SharedWavetable>(std::move(table));
+}
+
+/**
+Band limit is decided from MIDI note number. Note number is converted to octave above
+`tableBaseFreq`, and 2 levels around it are linearly interpolated. Lower level has a
+little aliasing when `levelFrac` is not 0, but its gain is `1 - levelFrac`, so the band
+limit changes smoothly across octaves.
+*/
 struct TableOsc {
-  float phase = 0;
+  float phase = 0; // In samples of level 0.
   float tick = 0;
-  size_t tableIndex = 0;
+  float tableBaseFreq = 20.0f;
+  size_t level = 0;
+  float levelFrac = 0;
+  float levelScale = 1; // 1 / 2^level. Converts phase to index of the level.
 
   void
   setFrequency(float notePitch, float frequency, float tableBaseFreq, size_t tableSize)
   {
-    tableIndex = size_t(notePitch);
-    if (tableIndex > maxMidiNoteNumber) tableIndex = maxMidiNoteNumber - 1;
+    this->tableBaseFreq = tableBaseFreq;
+    setTableIndex(notePitch);
 
     tick = frequency / tableBaseFreq;
     if (tick >= tableSize || tick < 0.0f) tick = 0;
   }
 
+  void setTableIndex(float notePitch)
+  {
+    const float octave = (notePitch - 69.0f) / 12.0f + log2f(440.0f / tableBaseFreq);
+    if (!(octave > 0.0f)) {
+      level = 0;
+      levelFrac = 0;
+    } else {
+      level = size_t(octave);
+      levelFrac = octave - float(level);
+    }
+    levelScale = std::ldexp(1.0f, -int(level));
+  }
+
   // Input phase is normalized in [0, 1], member phase is in [0, tableSize].
   void setPhase(float phase, size_t tableSize)
   {
@@ -261,15 +458,29 @@ struct TableOsc {
 
   void reset() { phase = 0; }
 
-  float process(std::vector<std::vector<float>> &table, size_t tableSize)
+  // `tickRatio` is pitch bend as frequency ratio.
+  float process(
+    const std::vector<std::vector<float>> &table,
+    size_t tableSize,
+    float tickRatio = 1.0f)
   {
-    const auto &tbl = table[tableIndex];
+    phase += tick * tickRatio;
+    if (phase >= tableSize) phase = fmodf(phase, float(tableSize));
 
-    phase += tick;
-    if (phase >= tableSize) phase -= tableSize;
+    const size_t last = table.size() - 1;
+    if (level >= last) return interp(table[last], std::ldexp(1.0f, -int(last)));
+
+    const float lower = interp(table[level], levelScale);
+    if (levelFrac == 0) return lower;
+    return lower + levelFrac * (interp(table[level + 1], 0.5f * levelScale) - lower);
+  }
 
-    size_t x0 = phase;
-    return tbl[x0] + (phase - floorf(phase)) * (tbl[x0 + 1] - tbl[x0]);
+  // Scaling by power of 2 is exact, so all levels are read at the same position.
+  inline float interp(const std::vector<float> &tbl, float scale)
+  {
+    const float x = phase * scale;
+    const size_t x0 = size_t(x);
+    return tbl[x0] + (x - floorf(x)) * (tbl[x0 + 1] - tbl[x0]);
   }
 };
 
@@ -0,0 +1,96 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+/*
+Measures processing time against real-time budget, and decides how much the DSP should
+reduce its cost. Used in `run()` of `plugin.cpp`.
+
+Load is `(processing time) / (buffer length in seconds)`, smoothed over `loadTime`.
+Level goes up by one when load exceeds `upperLoad`. Consecutive steps are at least
+`settleTime` apart, so the effect of previous step can be seen before the next one.
+Level goes down by one after load stays below `lowerLoad` for `recoverTime`. The gap
+between two thresholds and long recover time are the hysteresis to prevent flapping.
+
+Meaning of each level is up to the DSP. Level 0 must be the normal operation.
+*/
+class CpuGovernor {
+public:
+  static constexpr uint32_t maxLevel = 3;
+  static constexpr double upperLoad = 0.7;
+  static constexpr double lowerLoad = 0.3;
+  static constexpr double loadTime = 0.05;   // In seconds.
+  static constexpr double settleTime = 0.1;  // In seconds.
+  static constexpr double recoverTime = 2.0; // In seconds.
+
+  void setup(double sampleRate)
+  {
+    this->sampleRate = sampleRate;
+    reset();
+  }
+
+  void reset()
+  {
+    level = 0;
+    load = 0;
+    sinceChange = 0;
+    belowLower = 0;
+  }
+
+  uint32_t getLevel() const { return level; }
+  double getLoad() const { return load; }
+
+  void begin() { start = Clock::now(); }
+
+  void end(uint32_t frames)
+  {
+    if (frames == 0 || sampleRate <= 0) return;
+
+    const double budget = frames / sampleRate;
+    const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    load += (1.0 - std::exp(-budget / loadTime)) * (elapsed / budget - load);
+
+    sinceChange += budget;
+    belowLower = load < lowerLoad ? belowLower + budget : 0;
+
+    if (load > upperLoad) {
+      if (level < maxLevel && sinceChange >= settleTime) {
+        ++level;
+        sinceChange = 0;
+      }
+    } else if (level > 0 && belowLower >= recoverTime) {
+      --level;
+      sinceChange = 0;
+      belowLower = 0;
+    }
+  }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  double sampleRate = 44100;
+  uint32_t level = 0;
+  double load = 0;
+  double sinceChange = 0; // In seconds.
+  double belowLower = 0;  // In seconds.
+  Clock::time_point start{};
+};
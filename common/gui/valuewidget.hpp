@@ -112,6 +112,6 @@ public:
   virtual void updateValue()
   {
     if (ui == nullptr || id.size() != value.size()) return;
-    for (size_t i = 0; i < id.size(); ++i) ui->updateValue(id[i], value[i]);
+    ui->updateValues(id, value);
   }
 };
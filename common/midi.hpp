@@ -0,0 +1,257 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+
+// Per-note expression. All zero is neutral.
+struct NoteExpression {
+  float bend = 0;     // In semitones.
+  float pressure = 0; // In [0, 1].
+  float timbre = 0;   // In [-1, 1). MIDI CC 74 where 64 is center.
+};
+
+/*
+Maps MIDI key number to note ID. Used in `handleMidi()` of `plugin.cpp`.
+
+Storage is fixed size, so note-on/off never allocates and lookup is constant time.
+Only one ID is held for each key. When a key is struck again without note-off, the
+previous note is released before the new note-on is sent.
+
+Sustain (CC 64) and sostenuto (CC 66) pedals defer note-off until the pedal is released.
+When a key held by pedal is struck again, note-on is sent with the same ID, so the DSP
+retriggers the voice of the ID instead of spawning a new one. This keeps voice count
+bounded under pedal.
+
+`DSP` is required to have `pushMidiNote` which has same signature as `DSPCore`. Call
+`reset()` together with `DSPCore::reset()`, because the table must not refer to the notes
+which are already stopped.
+
+MPE is enabled when MPE configuration message (RPN 6) is received on channel 1 (lower
+zone) or 16 (upper zone). Pitch bend on member channel is then routed to the notes on
+the channel, instead of global pitch bend. Channel pressure and CC 74 are always routed
+to the notes on the channel. Expression is sent once per processing cycle by
+`sendExpression()`, which requires `DSP` to have `setNoteExpression`.
+*/
+class NoteIdTable {
+public:
+  static constexpr size_t nKey = 128;
+  static constexpr size_t nChannel = 16;
+  static constexpr float mpeBendRange = 48.0f; // MPE default for member channel.
+  static constexpr uint8_t rpnNull = 0x7f;
+
+  template<typename DSP>
+  void noteOn(DSP &dsp, uint32_t frame, uint8_t key, uint8_t velocity, uint8_t ch = 0)
+  {
+    key &= 0x7f;
+    ch &= 0x0f;
+
+    // Discard duplicate note-on in a same processing cycle.
+    if (isReceived[key]) return;
+    isReceived.set(key);
+
+    const bool isHeldByPedal = isActive[key] && !isKeyDown[key];
+    if (isHeldByPedal) {
+      dsp.pushMidiNote(true, frame, noteId[key], key, 0.0f, velocity / float(INT8_MAX));
+    } else {
+      if (isActive[key]) dsp.pushMidiNote(false, frame, noteId[key], 0, 0, 0);
+
+      dsp.pushMidiNote(true, frame, nextId, key, 0.0f, velocity / float(INT8_MAX));
+      noteId[key] = nextId;
+      isActive.set(key);
+      nextId += 1;
+    }
+    channel[key] = ch;
+    isKeyDown.set(key);
+
+    isExpressionChanged.set(ch);
+  }
+
+  template<typename DSP> void noteOff(DSP &dsp, uint32_t frame, uint8_t key)
+  {
+    key &= 0x7f;
+
+    // Note-off followed by note-on in a same cycle is not a duplicate.
+    isReceived.reset(key);
+
+    if (!isActive[key]) return;
+    isKeyDown.reset(key);
+    if (isSustainOn || isSostenutoHeld[key]) return;
+    release(dsp, frame, key);
+  }
+
+  // Returns false if the bend is not consumed. In this case, caller should apply the
+  // bend to global pitch bend parameter. `value` is 14 bit where center is 8192.
+  bool pitchBend(uint8_t ch, uint16_t value)
+  {
+    ch &= 0x0f;
+    if (!isMemberChannel[ch]) return false;
+    expression[ch].bend = mpeBendRange * (int32_t(value) - 8192) / 8192.0f;
+    isExpressionChanged.set(ch);
+    return true;
+  }
+
+  void channelPressure(uint8_t ch, uint8_t value)
+  {
+    ch &= 0x0f;
+    expression[ch].pressure = (value & 0x7f) / float(INT8_MAX);
+    isExpressionChanged.set(ch);
+  }
+
+  template<typename DSP>
+  void controlChange(DSP &dsp, uint32_t frame, uint8_t ch, uint8_t cc, uint8_t value)
+  {
+    ch &= 0x0f;
+    value &= 0x7f;
+    switch (cc) {
+      case 6: // Data entry MSB.
+        if (rpnMsb[ch] == 0 && rpnLsb[ch] == 6) configureMpe(ch, value);
+        break;
+
+      case 64: // Sustain pedal.
+        isSustainOn = value >= 64;
+        if (!isSustainOn) releasePedal(dsp, frame, ~isSostenutoHeld);
+        break;
+
+      case 66: { // Sostenuto pedal. Only holds the keys which are down on press.
+        const bool isOn = value >= 64;
+        if (isOn == isSostenutoOn) break;
+        isSostenutoOn = isOn;
+        if (isSostenutoOn) {
+          isSostenutoHeld = isActive & isKeyDown;
+        } else {
+          const auto held = isSostenutoHeld;
+          isSostenutoHeld.reset();
+          if (!isSustainOn) releasePedal(dsp, frame, held);
+        }
+      } break;
+
+      case 74: // Timbre.
+        expression[ch].timbre = (int32_t(value) - 64) / 64.0f;
+        isExpressionChanged.set(ch);
+        break;
+
+      case 100: // RPN LSB.
+        rpnLsb[ch] = value;
+        break;
+
+      case 101: // RPN MSB.
+        rpnMsb[ch] = value;
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  // Call this once after all events in a processing cycle are handled.
+  template<typename DSP> void sendExpression(DSP &dsp)
+  {
+    if (isExpressionChanged.none()) return;
+    for (size_t key = 0; key < nKey; ++key) {
+      if (isActive[key] && isExpressionChanged[channel[key]])
+        dsp.setNoteExpression(noteId[key], expression[channel[key]]);
+    }
+    isExpressionChanged.reset();
+  }
+
+  // Call this at the end of each processing cycle.
+  void endCycle() { isReceived.reset(); }
+
+  // Releases the notes held by pedals, and turns pedals off. Used on transport start,
+  // where playing notes continue but pedal state from previous playback is stale.
+  template<typename DSP> void resetPedal(DSP &dsp, uint32_t frame)
+  {
+    isSustainOn = false;
+    isSostenutoOn = false;
+    isSostenutoHeld.reset();
+    releasePedal(dsp, frame, std::bitset<nKey>().set());
+  }
+
+  // Forgets all notes, pedals and MPE configuration. Call this when DSP voices are reset.
+  void reset()
+  {
+    noteId.fill(0);
+    channel.fill(0);
+    isActive.reset();
+    isReceived.reset();
+    isKeyDown.reset();
+    isSostenutoHeld.reset();
+    isSustainOn = false;
+    isSostenutoOn = false;
+    isExpressionChanged.reset();
+    expression.fill({});
+    isMemberChannel.reset();
+    rpnMsb.fill(rpnNull);
+    rpnLsb.fill(rpnNull);
+  }
+
+private:
+  template<typename DSP> void release(DSP &dsp, uint32_t frame, uint8_t key)
+  {
+    dsp.pushMidiNote(false, frame, noteId[key], 0, 0, 0);
+    isActive.reset(key);
+  }
+
+  // Releases active keys in `mask` which are already up.
+  template<typename DSP>
+  void releasePedal(DSP &dsp, uint32_t frame, const std::bitset<nKey> &mask)
+  {
+    const auto target = isActive & ~isKeyDown & mask;
+    if (target.none()) return;
+    for (size_t key = 0; key < nKey; ++key) {
+      if (target[key]) release(dsp, frame, uint8_t(key));
+    }
+  }
+
+  // Number of member channels `nMember` is in [0, 15]. 0 disables the zone.
+  void configureMpe(uint8_t ch, uint8_t nMember)
+  {
+    if (nMember > nChannel - 1) nMember = nChannel - 1;
+    if (ch == 0) {
+      for (size_t idx = 1; idx < nChannel; ++idx) isMemberChannel[idx] = idx <= nMember;
+    } else if (ch == nChannel - 1) {
+      for (size_t idx = 0; idx < nChannel - 1; ++idx)
+        isMemberChannel[idx] = idx >= nChannel - 1 - nMember;
+    }
+  }
+
+  uint32_t nextId = 0;
+  std::array<uint32_t, nKey> noteId{};
+  std::array<uint8_t, nKey> channel{};
+  std::bitset<nKey> isActive;
+  std::bitset<nKey> isReceived;
+  std::bitset<nKey> isKeyDown;
+  std::bitset<nKey> isSostenutoHeld;
+  bool isSustainOn = false;
+  bool isSostenutoOn = false;
+
+  std::array<NoteExpression, nChannel> expression{};
+  std::bitset<nChannel> isExpressionChanged;
+  std::bitset<nChannel> isMemberChannel;
+  std::array<uint8_t, nChannel> rpnMsb{rpnNull, rpnNull, rpnNull, rpnNull,
+                                       rpnNull, rpnNull, rpnNull, rpnNull,
+                                       rpnNull, rpnNull, rpnNull, rpnNull,
+                                       rpnNull, rpnNull, rpnNull, rpnNull};
+  std::array<uint8_t, nChannel> rpnLsb{rpnNull, rpnNull, rpnNull, rpnNull,
+                                       rpnNull, rpnNull, rpnNull, rpnNull,
+                                       rpnNull, rpnNull, rpnNull, rpnNull,
+                                       rpnNull, rpnNull, rpnNull, rpnNull};
+};
@@ -0,0 +1,154 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+struct ParameterEvent {
+  uint32_t frame; // Offset from the start of processing cycle.
+  uint32_t id;
+  double value; // Same as the argument of `GlobalParameter::setParameterValue`.
+};
+
+/*
+Transports parameter changes to audio thread. Used in `plugin.cpp`.
+
+`push()` is for the threads which call `setParameterValue()`. Host changes don't have
+frame, so only the latest value of each parameter matters. `push()` stores it into a
+per parameter atomic slot, and later pushes to the same parameter overwrite it. It
+doesn't fail for a valid `id`, so a change is never written around the queue and never
+overtaken by an older one. Any number of threads can push at once, as VST2 hosts may do.
+`get()` returns the value which is pushed but not yet taken by audio thread, for
+`getParameterValue()`.
+
+Rest of the methods are audio thread only. `schedule()` adds an event which is made in
+`run()`, like pitch bend from MIDI. It must be called before `render()` in a cycle. When
+`capacity` events are scheduled, the oldest event of the same `id` is dropped.
+
+`render()` splits a processing cycle at the frames of events, and calls `apply` for each
+event and `process(offset, length, isChanged)` for each sub-block. So a change lands on
+the exact frame instead of the start of next cycle. `apply` returns true if the event
+changed a value. `isChanged` is true for the first sub-block, and for a following
+sub-block only if an event before it changed a value, so DSP can skip recomputing
+parameters otherwise. `flush()` applies all pending events at once, and should be called
+when the cycle is skipped (e.g. bypass).
+*/
+template<size_t nParameter, size_t capacity> class ParameterEventQueue {
+public:
+  bool push(uint32_t id, double value)
+  {
+    if (id >= nParameter) return false;
+    latest[id].store(value, std::memory_order_relaxed);
+    isPushed[id].store(true, std::memory_order_release);
+    isAnyPushed.store(true, std::memory_order_release);
+    return true;
+  }
+
+  bool get(uint32_t id, double &value) const
+  {
+    if (id >= nParameter || !isPushed[id].load(std::memory_order_acquire)) return false;
+    value = latest[id].load(std::memory_order_relaxed);
+    return true;
+  }
+
+  bool schedule(uint32_t id, double value, uint32_t frame)
+  {
+    if (nPending >= capacity && !dropOldest(id)) return false;
+    insert({frame, id, value});
+    return true;
+  }
+
+  template<typename Apply, typename Process>
+  void render(uint32_t frames, Apply apply, Process process)
+  {
+    receive();
+
+    size_t index = 0;
+    uint32_t start = 0;
+    bool isChanged = true;
+    while (start < frames) {
+      while (index < nPending && pending[index].frame <= start) {
+        if (apply(pending[index++])) isChanged = true;
+      }
+
+      const uint32_t end = index < nPending && pending[index].frame < frames
+        ? pending[index].frame
+        : frames;
+      process(start, end - start, isChanged);
+      start = end;
+      isChanged = false;
+    }
+
+    // Events beyond the cycle are applied at the end, rather than left stale.
+    while (index < nPending) apply(pending[index++]);
+    nPending = 0;
+  }
+
+  template<typename Apply> void flush(Apply apply)
+  {
+    receive();
+    for (size_t idx = 0; idx < nPending; ++idx) apply(pending[idx]);
+    nPending = 0;
+  }
+
+private:
+  // Moves pushed values to `pending` as events on frame 0. A push which lands during the
+  // scan is either taken now or left flagged for the next cycle.
+  void receive()
+  {
+    if (!isAnyPushed.exchange(false, std::memory_order_acquire)) return;
+    for (uint32_t id = 0; id < nParameter; ++id) {
+      if (!isPushed[id].exchange(false, std::memory_order_acquire)) continue;
+      insert({0, id, latest[id].load(std::memory_order_relaxed)});
+    }
+  }
+
+  bool dropOldest(uint32_t id)
+  {
+    for (size_t idx = 0; idx < nPending; ++idx) {
+      if (pending[idx].id != id) continue;
+      for (; idx + 1 < nPending; ++idx) pending[idx] = pending[idx + 1];
+      --nPending;
+      return true;
+    }
+    return false;
+  }
+
+  // Insertion sort by frame. Order of events on a same frame is preserved. Events mostly
+  // come in order, so this is usually a single comparison.
+  void insert(const ParameterEvent &event)
+  {
+    size_t idx = nPending++;
+    while (idx > 0 && pending[idx - 1].frame > event.frame) {
+      pending[idx] = pending[idx - 1];
+      --idx;
+    }
+    pending[idx] = event;
+  }
+
+  std::array<std::atomic<double>, nParameter> latest{};
+  std::array<std::atomic<bool>, nParameter> isPushed{};
+  alignas(64) std::atomic<bool> isAnyPushed{false};
+
+  // Each parameter has at most one pushed event per cycle, plus `capacity` scheduled.
+  std::array<ParameterEvent, nParameter + capacity> pending{};
+  size_t nPending = 0;
+};
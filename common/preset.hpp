@@ -0,0 +1,57 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+Compiled-in preset is stored as a table of `PresetEntry`, which is generated by
+`preset/jsontocpp.py` into `parameter_preset.cpp`. Adding a preset only adds data, not
+code.
+
+Integer parameters are stored as raw value, and others are stored as normalized value.
+`double` is used to keep seed and the values in existing presets exact. Parameters which
+don't appear in the table are left unchanged.
+
+`loadPresetData()` goes through setters instead of copying raw values into
+`ParameterStore`, because metadata holds its own copy of each value, and the scaling
+to DSP units is only defined in C++ `Scales`. A preset has at most a few hundred
+entries and is loaded once per program change, so the virtual calls are cheap.
+*/
+struct PresetEntry {
+  uint32_t id;
+  uint32_t isInt;
+  double value;
+};
+
+struct PresetData {
+  const PresetEntry *entry;
+  size_t size;
+};
+
+template<typename Store> void loadPresetData(Store &value, const PresetData &preset)
+{
+  for (size_t idx = 0; idx < preset.size; ++idx) {
+    const auto &entry = preset.entry[idx];
+    if (entry.isInt)
+      value[entry.id]->setFromInt(uint32_t(entry.value));
+    else
+      value[entry.id]->setFromNormalized(entry.value);
+  }
+}
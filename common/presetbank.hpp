@@ -0,0 +1,195 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+Read-only preset bank file which is memory mapped. Used in `plugin.cpp` to add user
+presets after compiled-in presets.
+
+File is at `$XDG_CONFIG_HOME/UhhyouPlugins/preset/PluginName.bank`, and can be made by
+`preset/jsontobank.py`. All numbers are little endian.
+
+| Offset        | Size                 | Content                                   |
+| ------------- | -------------------- | ----------------------------------------- |
+| 0             | 8                    | Magic `UHYPBANK`.                         |
+| 8             | 4                    | Version. Currently 1.                     |
+| 12            | 4                    | `nParameter`.                             |
+| 16            | 4                    | `nPreset`.                                |
+| 20            | 4                    | `nameSize`. Includes terminating null.    |
+| 24            | 8                    | `typeOffset`.                             |
+| 32            | 8                    | `nameOffset`.                             |
+| 40            | 8                    | `valueOffset`. Aligned to 4 bytes.        |
+| 48            | 16                   | Reserved.                                 |
+| `typeOffset`  | `nParameter`         | 1 for integer parameter, otherwise 0.     |
+| `nameOffset`  | `nPreset * nameSize` | Null terminated names in fixed size slot. |
+| `valueOffset` | `nPreset * rowSize`  | Values of presets. See below.             |
+
+`rowSize` is `4 * nParameter`. Each value is `uint32_t` raw value for integer parameter,
+otherwise `float` normalized value.
+
+`open()` only validates the header, so it's cheap even if the bank has thousands of
+presets. Pages are read by OS when they are touched. `load()` doesn't allocate memory,
+so it can be called from audio thread.
+
+When `nParameter` is different from the plugin, for example the bank is made by an older
+version, only the parameters in both are loaded.
+*/
+class PresetBank {
+public:
+  static constexpr uint32_t version = 1;
+  static constexpr size_t headerSize = 64;
+
+  static std::string getDefaultPath(const char *pluginName)
+  {
+    std::string dir;
+    if (const char *config = std::getenv("XDG_CONFIG_HOME")) {
+      dir = config;
+    } else if (const char *home = std::getenv("HOME")) {
+      dir = std::string(home) + "/.config";
+    } else {
+      return "";
+    }
+    return dir + "/UhhyouPlugins/preset/" + pluginName + ".bank";
+  }
+
+  PresetBank() {}
+  PresetBank(const std::string &path) { open(path); }
+  PresetBank(const PresetBank &) = delete;
+  PresetBank &operator=(const PresetBank &) = delete;
+  ~PresetBank() { close(); }
+
+  bool open(const std::string &path)
+  {
+    close();
+    if (path.empty()) return false;
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || uint64_t(st.st_size) < headerSize) {
+      ::close(fd);
+      return false;
+    }
+
+    void *ptr = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (ptr == MAP_FAILED) return false;
+
+    data = static_cast<const uint8_t *>(ptr);
+    dataSize = size_t(st.st_size);
+    if (!readHeader()) close();
+    return nPreset > 0;
+  }
+
+  void close()
+  {
+    if (data != nullptr) munmap(const_cast<uint8_t *>(data), dataSize);
+    data = nullptr;
+    dataSize = 0;
+    nParameter = 0;
+    nPreset = 0;
+  }
+
+  uint32_t size() const { return nPreset; }
+
+  const char *getName(uint32_t index) const
+  {
+    if (index >= nPreset) return "";
+    const char *name = reinterpret_cast<const char *>(data + nameOffset)
+      + size_t(index) * nameSize;
+    return name[nameSize - 1] == '\0' ? name : "";
+  }
+
+  template<typename Store> bool load(uint32_t index, Store &value) const
+  {
+    if (index >= nPreset) return false;
+
+    const uint8_t *type = data + typeOffset;
+    const uint8_t *slot = data + valueOffset + size_t(index) * nParameter * 4;
+    const size_t length = nParameter < value.size() ? nParameter : value.size();
+    for (size_t id = 0; id < length; ++id) {
+      if (type[id]) {
+        uint32_t raw;
+        std::memcpy(&raw, slot + 4 * id, 4);
+        value[id]->setFromInt(raw);
+      } else {
+        float normalized;
+        std::memcpy(&normalized, slot + 4 * id, 4);
+        value[id]->setFromNormalized(normalized);
+      }
+    }
+    return true;
+  }
+
+private:
+  template<typename T> T read(size_t offset) const
+  {
+    T dest;
+    std::memcpy(&dest, data + offset, sizeof(T));
+    return dest;
+  }
+
+  bool readHeader()
+  {
+    if (std::memcmp(data, "UHYPBANK", 8) != 0) return false;
+    if (read<uint32_t>(8) != version) return false;
+
+    const uint64_t nParam = read<uint32_t>(12);
+    const uint64_t nPst = read<uint32_t>(16);
+    const uint64_t nmSize = read<uint32_t>(20);
+    const uint64_t typeOfs = read<uint64_t>(24);
+    const uint64_t nameOfs = read<uint64_t>(32);
+    const uint64_t valueOfs = read<uint64_t>(40);
+
+    // Products of two 32 bit counts don't overflow. Offsets are checked first.
+    if (nmSize == 0 || valueOfs % 4 != 0) return false;
+    if (typeOfs > dataSize || nameOfs > dataSize || valueOfs > dataSize) return false;
+    if (nParam > dataSize - typeOfs) return false;
+    if (nPst * nmSize > dataSize - nameOfs) return false;
+    if (nPst * nParam > (dataSize - valueOfs) / 4) return false;
+
+    nParameter = uint32_t(nParam);
+    nPreset = uint32_t(nPst);
+    nameSize = uint32_t(nmSize);
+    typeOffset = size_t(typeOfs);
+    nameOffset = size_t(nameOfs);
+    valueOffset = size_t(valueOfs);
+    return true;
+  }
+
+  const uint8_t *data = nullptr;
+  size_t dataSize = 0;
+
+  uint32_t nParameter = 0;
+  uint32_t nPreset = 0;
+  uint32_t nameSize = 0;
+  size_t typeOffset = 0;
+  size_t nameOffset = 0;
+  size_t valueOffset = 0;
+};
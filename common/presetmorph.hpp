@@ -0,0 +1,64 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+
+/*
+Morphs the sound to a newly loaded preset by slowing down DSP smoothers for a while.
+
+Parameters are written to the store at once in `loadProgram()`, so host reads back the
+new preset right away. Only the DSP side follows slowly. `start()` is called from
+`loadProgram()` after the preset is written. `DSPCore::setParameters()` passes the
+result of `getSmoothingTime()` to `SmootherCommon::setTime()`, and `DSPCore::process()`
+calls `process()` to count down.
+
+All DSP values of the reverbs go through `ExpSmoother`, and they share the time of
+`SmootherCommon`. Cutoff of smoother is `1 / seconds`, so the values are settled within
+0.2% at the end of morph. Integer parameters, `bypass` and `presetMorphTime` aren't
+smoothed, so they are not morphed.
+*/
+class PresetMorph {
+public:
+  // Host thread.
+  void start(double seconds) { requested.store(seconds, std::memory_order_release); }
+
+  // Audio thread. Returns the smoothing time in seconds.
+  double getSmoothingTime(double smoothness, double sampleRate)
+  {
+    const double seconds = requested.exchange(0.0, std::memory_order_acquire);
+    if (seconds > 0) {
+      morphTime = seconds;
+      remaining = seconds * sampleRate;
+    }
+    return remaining > 0 ? std::max(morphTime, smoothness) : smoothness;
+  }
+
+  // Audio thread.
+  void process(size_t length)
+  {
+    if (remaining > 0) remaining -= double(length);
+  }
+
+private:
+  std::atomic<double> requested{0.0};
+  double morphTime = 0; // In seconds.
+  double remaining = 0; // In samples.
+};
@@ -0,0 +1,151 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/*
+Binary snapshot of parameters. Used in `getState()` and `setState()` of `plugin.cpp`.
+DPF state is a string, so the binary is stored as base64. All numbers are little endian.
+
+| Offset | Size             | Content                                      |
+| ------ | ---------------- | -------------------------------------------- |
+| 0      | 8                | Magic `UHYSNAPS`.                            |
+| 8      | 4                | Version. Currently 1.                        |
+| 12     | 4                | `nParameter`.                                |
+| 16     | `8 * nParameter` | Raw value of parameters, stored as `double`. |
+
+`decode()` restores all parameters at once, so derived state is computed once from the
+final values instead of once per parameter. When `nParameter` is different from the
+plugin, only the parameters in both are restored.
+
+Derived tables are not stored. They can be tens of megabytes. Instead, `hash()` makes a
+key from the parameters which the table depends on. DSP keeps the key of current table,
+and skips regeneration when the key is unchanged.
+*/
+class StateSnapshot {
+public:
+  static constexpr uint32_t version = 1;
+  static constexpr size_t headerSize = 16;
+  static constexpr uint64_t hashBasis = 0xcbf29ce484222325; // FNV-1a 64 bit.
+
+  // Hashes raw values of parameters in `[first, last]`. Chain calls by passing the
+  // previous return value to `hash`.
+  template<typename Store>
+  static uint64_t hash(Store &value, size_t first, size_t last, uint64_t hash = hashBasis)
+  {
+    for (size_t id = first; id <= last; ++id)
+      hash = hashBytes(value[id]->getFloat(), hash);
+    return hash;
+  }
+
+  template<typename T> static uint64_t hashBytes(T data, uint64_t hash = hashBasis)
+  {
+    uint8_t bytes[sizeof(T)];
+    std::memcpy(bytes, &data, sizeof(T));
+    for (size_t i = 0; i < sizeof(T); ++i) {
+      hash ^= bytes[i];
+      hash *= 0x100000001b3;
+    }
+    return hash;
+  }
+
+  template<typename Store> static std::string encode(Store &value)
+  {
+    const uint32_t nParameter = uint32_t(value.size());
+
+    std::vector<uint8_t> data(headerSize + 8 * size_t(nParameter));
+    std::memcpy(data.data(), "UHYSNAPS", 8);
+    std::memcpy(data.data() + 8, &version, 4);
+    std::memcpy(data.data() + 12, &nParameter, 4);
+    for (size_t id = 0; id < nParameter; ++id) {
+      const double raw = value[id]->getFloat();
+      std::memcpy(data.data() + headerSize + 8 * id, &raw, 8);
+    }
+    return toBase64(data);
+  }
+
+  template<typename Store> static bool decode(const char *text, Store &value)
+  {
+    std::vector<uint8_t> data;
+    if (!fromBase64(text, data) || data.size() < headerSize) return false;
+    if (std::memcmp(data.data(), "UHYSNAPS", 8) != 0) return false;
+
+    uint32_t ver;
+    uint32_t nParameter;
+    std::memcpy(&ver, data.data() + 8, 4);
+    std::memcpy(&nParameter, data.data() + 12, 4);
+    if (ver != version) return false;
+    if (nParameter > (data.size() - headerSize) / 8) return false;
+
+    const size_t length = nParameter < value.size() ? nParameter : value.size();
+    for (size_t id = 0; id < length; ++id) {
+      double raw;
+      std::memcpy(&raw, data.data() + headerSize + 8 * id, 8);
+      if (value[id]->isInteger())
+        value[id]->setFromInt(raw >= 0 ? uint32_t(raw) : 0);
+      else
+        value[id]->setFromFloat(raw);
+    }
+    return true;
+  }
+
+private:
+  static constexpr char base64Table[]
+    = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+  static std::string toBase64(const std::vector<uint8_t> &data)
+  {
+    std::string text;
+    text.reserve((data.size() + 2) / 3 * 4);
+    for (size_t i = 0; i < data.size(); i += 3) {
+      uint32_t chunk = uint32_t(data[i]) << 16;
+      if (i + 1 < data.size()) chunk |= uint32_t(data[i + 1]) << 8;
+      if (i + 2 < data.size()) chunk |= uint32_t(data[i + 2]);
+
+      text += base64Table[(chunk >> 18) & 63];
+      text += base64Table[(chunk >> 12) & 63];
+      text += i + 1 < data.size() ? base64Table[(chunk >> 6) & 63] : '=';
+      text += i + 2 < data.size() ? base64Table[chunk & 63] : '=';
+    }
+    return text;
+  }
+
+  static bool fromBase64(const char *text, std::vector<uint8_t> &data)
+  {
+    if (text == nullptr) return false;
+
+    uint32_t chunk = 0;
+    int bits = 0;
+    for (; *text != '\0' && *text != '='; ++text) {
+      const char *pos = std::strchr(base64Table, *text);
+      if (pos == nullptr) return false;
+      chunk = (chunk << 6) | uint32_t(pos - base64Table);
+      bits += 6;
+      if (bits >= 8) {
+        bits -= 8;
+        data.push_back(uint8_t(chunk >> bits));
+      }
+    }
+    return true;
+  }
+};
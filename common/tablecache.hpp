@@ -0,0 +1,95 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+/*
+Process wide cache of immutable tables. Plugin instances which request the same `key`
+share one table, and only the first one builds it.
+
+`key` is a hash of all the inputs of a table, for example made by
+`StateSnapshot::hash()`. Cache only holds `std::weak_ptr`, so a table is freed when the
+last instance releases it. Expired entries are removed on next insertion.
+
+`get()` can be called from any thread. It blocks while building. Builds of the same
+`Table` type are serialized, so a second request of the same key waits for the first one
+instead of building twice. Different `Table` types build concurrently, so a builder which
+calls FFTW planner must lock `fftwPlannerMutex()` by itself.
+*/
+/*
+FFTW planner, including `fftwf_destroy_plan()`, is not thread safe. Only
+`fftwf_execute*()` can run concurrently. This one mutex is shared by all plugin
+instances and table types in the process.
+*/
+inline std::mutex &fftwPlannerMutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
+
+template<typename Table> class TableCache {
+public:
+  static TableCache &instance()
+  {
+    static TableCache cache;
+    return cache;
+  }
+
+  TableCache(const TableCache &) = delete;
+  TableCache &operator=(const TableCache &) = delete;
+
+  // `build` is a function which returns `std::unique_ptr<Table>` or
+  // `std::shared_ptr<Table>`.
+  template<typename Build> std::shared_ptr<const Table> get(uint64_t key, Build build)
+  {
+    if (auto table = find(key)) return table;
+
+    std::lock_guard<std::mutex> buildLock(buildMutex);
+    if (auto table = find(key)) return table; // Built while waiting.
+
+    std::shared_ptr<const Table> table(build());
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = entries.begin(); it != entries.end();) {
+      if (it->second.expired())
+        it = entries.erase(it);
+      else
+        ++it;
+    }
+    entries[key] = table;
+    return table;
+  }
+
+private:
+  TableCache() {}
+
+  std::shared_ptr<const Table> find(uint64_t key)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    return it == entries.end() ? nullptr : it->second.lock();
+  }
+
+  std::mutex mutex; // Guards `entries`.
+  std::mutex buildMutex;
+  std::unordered_map<uint64_t, std::weak_ptr<const Table>> entries;
+};
@@ -0,0 +1,194 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+On-disk cache of generated table, which is memory mapped read-only. Used by
+`TableCache` builders to skip FFT when the same table was made in previous session.
+
+File is at `$XDG_CACHE_HOME/UhhyouPlugins/table/PluginName/Version/Key.table`. `Key` is
+the table key in 16 hex digits. Plugin version is in the path, so a table made by other
+version is never read. All numbers are little endian.
+
+| Offset | Size         | Content                     |
+| ------ | ------------ | --------------------------- |
+| 0      | 8            | Magic `UHYTABLE`.           |
+| 8      | 4            | Version. Currently 1.       |
+| 12     | 4            | Reserved.                   |
+| 16     | 8            | Key.                        |
+| 24     | 8            | `nFloat`.                   |
+| 32     | `4 * nFloat` | Table data as `float`.      |
+
+Layout of table data is decided by each table. A table passes its arrays as `Chunk` to
+`write()`, and reads them back in the same order from `data()`.
+
+`write()` writes to a temporary file and renames it, so other processes never see a
+partially written file. Nothing is deleted automatically. Remove the directory to clear
+the cache.
+*/
+class TableFile {
+public:
+  static constexpr uint32_t version = 1;
+  static constexpr size_t headerSize = 32;
+
+  struct Chunk {
+    const float *data;
+    size_t size;
+  };
+
+  static std::string
+  getDefaultDirectory(const char *pluginName, int major, int minor, int patch)
+  {
+    std::string dir;
+    if (const char *cache = std::getenv("XDG_CACHE_HOME")) {
+      dir = cache;
+    } else if (const char *home = std::getenv("HOME")) {
+      dir = std::string(home) + "/.cache";
+    } else {
+      return "";
+    }
+    return dir + "/UhhyouPlugins/table/" + pluginName + "/" + std::to_string(major) + "."
+      + std::to_string(minor) + "." + std::to_string(patch);
+  }
+
+  static std::string getPath(const std::string &directory, uint64_t key)
+  {
+    if (directory.empty()) return "";
+    char name[32];
+    std::snprintf(name, sizeof(name), "/%016llx.table", (unsigned long long)key);
+    return directory + name;
+  }
+
+  static bool
+  write(const std::string &path, uint64_t key, const std::vector<Chunk> &chunks)
+  {
+    if (path.empty() || !makeDirectory(path.substr(0, path.rfind('/')))) return false;
+
+    uint64_t nFloat = 0;
+    for (const auto &chunk : chunks) nFloat += chunk.size;
+
+    uint8_t header[headerSize]{};
+    std::memcpy(header, "UHYTABLE", 8);
+    std::memcpy(header + 8, &version, 4);
+    std::memcpy(header + 16, &key, 8);
+    std::memcpy(header + 24, &nFloat, 8);
+
+    const std::string tmpPath = path + "." + std::to_string(getpid()) + ".tmp";
+    FILE *fp = std::fopen(tmpPath.c_str(), "wb");
+    if (fp == nullptr) return false;
+
+    bool isOk = std::fwrite(header, 1, headerSize, fp) == headerSize;
+    for (const auto &chunk : chunks) {
+      if (!isOk) break;
+      isOk = std::fwrite(chunk.data, sizeof(float), chunk.size, fp) == chunk.size;
+    }
+    isOk = std::fclose(fp) == 0 && isOk;
+
+    if (isOk) isOk = std::rename(tmpPath.c_str(), path.c_str()) == 0;
+    if (!isOk) std::remove(tmpPath.c_str());
+    return isOk;
+  }
+
+  TableFile() {}
+  TableFile(const std::string &path, uint64_t key) { open(path, key); }
+  TableFile(const TableFile &) = delete;
+  TableFile &operator=(const TableFile &) = delete;
+  ~TableFile() { close(); }
+
+  bool open(const std::string &path, uint64_t key)
+  {
+    close();
+    if (path.empty()) return false;
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || uint64_t(st.st_size) < headerSize) {
+      ::close(fd);
+      return false;
+    }
+
+    void *ptr = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (ptr == MAP_FAILED) return false;
+
+    map = static_cast<const uint8_t *>(ptr);
+    mapSize = size_t(st.st_size);
+    if (!readHeader(key)) close();
+    return map != nullptr;
+  }
+
+  void close()
+  {
+    if (map != nullptr) munmap(const_cast<uint8_t *>(map), mapSize);
+    map = nullptr;
+    mapSize = 0;
+    nFloat = 0;
+  }
+
+  size_t size() const { return nFloat; }
+  const float *data() const
+  {
+    return map == nullptr ? nullptr : reinterpret_cast<const float *>(map + headerSize);
+  }
+
+private:
+  static bool makeDirectory(const std::string &path)
+  {
+    for (size_t pos = 1; pos <= path.size(); ++pos) {
+      if (pos < path.size() && path[pos] != '/') continue;
+      if (mkdir(path.substr(0, pos).c_str(), 0755) != 0 && errno != EEXIST) return false;
+    }
+    return true;
+  }
+
+  bool readHeader(uint64_t key)
+  {
+    if (std::memcmp(map, "UHYTABLE", 8) != 0) return false;
+
+    uint32_t ver;
+    uint64_t fileKey;
+    uint64_t nFlt;
+    std::memcpy(&ver, map + 8, 4);
+    std::memcpy(&fileKey, map + 16, 8);
+    std::memcpy(&nFlt, map + 24, 8);
+    if (ver != version || fileKey != key) return false;
+    if (nFlt > (mapSize - headerSize) / sizeof(float)) return false;
+
+    nFloat = size_t(nFlt);
+    return true;
+  }
+
+  const uint8_t *map = nullptr;
+  size_t mapSize = 0;
+  size_t nFloat = 0;
+};
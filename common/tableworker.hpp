@@ -0,0 +1,145 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/*
+Builds a table on a background thread, and swaps it in on audio thread.
+
+`Request` holds the inputs of a table, and provides
+`std::unique_ptr<Table> build(const std::string &cacheDirectory) const` which is called on
+the worker thread.
+
+`request()` copy assigns the request to the one held by the worker, on audio thread. The
+assignment must not allocate. Make `prototype` the same shape as the requests, for
+example the same vector size, so the assignment reuses its storage. Strings are kept out
+of the request for the same reason. Cache directory is given by `setCacheDirectory()`.
+
+- `request()` can be called from any thread. It doesn't wait for the lock, and returns
+  false when the worker is copying the previous request. Caller should retry later.
+  Requests made during a build are merged, and only the latest one is built next.
+- `receive()` is audio thread only. It swaps in a finished table, and returns true if
+  swapped. Until then, `get()` returns the previous table.
+
+The old table is freed on the worker thread, so audio thread doesn't allocate or free.
+Memory of 2 tables is used only while building.
+*/
+template<typename Table, typename Request> class TableWorker {
+public:
+  TableWorker(std::unique_ptr<Table> initial, Request prototype)
+    : current(initial.release())
+    , pending(std::move(prototype))
+    , thread([this]() { run(); })
+  {
+  }
+
+  TableWorker(const TableWorker &) = delete;
+  TableWorker &operator=(const TableWorker &) = delete;
+
+  ~TableWorker()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      isRunning = false;
+    }
+    condition.notify_one();
+    thread.join();
+
+    delete ready.exchange(nullptr);
+    delete retired.exchange(nullptr);
+    delete current;
+  }
+
+  Table &get() { return *current; }
+
+  // Call before audio thread starts. Empty string disables on-disk table cache.
+  void setCacheDirectory(const std::string &directory)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    cacheDirectory = directory;
+  }
+
+  bool request(const Request &req)
+  {
+    std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+    if (!lock.owns_lock()) return false;
+    pending = req;
+    isRequested = true;
+    lock.unlock();
+    condition.notify_one();
+    return true;
+  }
+
+  bool receive()
+  {
+    // Previous table is not freed yet. Wait for the worker to collect it.
+    if (retired.load(std::memory_order_acquire) != nullptr) return false;
+
+    Table *next = ready.exchange(nullptr, std::memory_order_acq_rel);
+    if (next == nullptr) return false;
+
+    retired.store(current, std::memory_order_release);
+    current = next;
+    return true;
+  }
+
+private:
+  void run()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (isRunning) {
+      // Timeout is for collecting the retired table without notification from audio
+      // thread.
+      condition.wait_for(lock, std::chrono::milliseconds(100), [&]() {
+        return isRequested || !isRunning;
+      });
+      delete retired.exchange(nullptr, std::memory_order_acq_rel);
+      if (!isRunning || !isRequested) continue;
+
+      Request req = pending;
+      const std::string directory = cacheDirectory;
+      isRequested = false;
+      lock.unlock();
+
+      // A table which is not received yet is outdated. It's never seen by audio thread.
+      delete ready.exchange(req.build(directory).release(), std::memory_order_acq_rel);
+
+      lock.lock();
+    }
+  }
+
+  Table *current = nullptr; // Audio thread only.
+  std::atomic<Table *> ready{nullptr};
+  std::atomic<Table *> retired{nullptr};
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  Request pending;
+  std::string cacheDirectory;
+  bool isRequested = false;
+  bool isRunning = true;
+
+  std::thread thread; // Must be the last member, so it starts after the others are made.
+};
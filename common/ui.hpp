@@ -20,12 +20,16 @@
 #include "DistrhoUI.hpp"
 
 #include <string>
+#include <vector>
 
 class PluginUI : public UI {
 public:
   PluginUI(uint width = 0, uint height = 0) : UI(width, height) {}
 
   virtual void updateValue(uint32_t index, float normalized) = 0;
+  virtual void updateValues(
+    const std::vector<uint32_t> &index, const std::vector<double> &normalized)
+    = 0;
   virtual void updateState(std::string key, std::string value) = 0;
   virtual void updateUI(uint32_t id, float normalized) = 0;
 };
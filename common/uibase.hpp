@@ -35,6 +35,7 @@
 #include "gui/textview.hpp"
 #include "gui/vslider.hpp"
 
+#include <algorithm>
 #include <memory>
 #include <tuple>
 #include <unordered_map>
@@ -84,6 +85,22 @@ protected:
     repaint();
   }
 
+  // Bulk version of `updateValue()` for `ArrayWidget`. Only values which are changed are
+  // sent to host, and repaint is requested once. Dragging a line on `BarBox` resends
+  // the whole array on every mouse event, but only a few bars change between events.
+  void updateValues(
+    const std::vector<uint32_t> &id, const std::vector<double> &normalized) override
+  {
+    const size_t length = std::min(id.size(), normalized.size());
+    for (size_t i = 0; i < length; ++i) {
+      if (id[i] >= param->idLength()) continue;
+      const double previous = param->getFloat(id[i]);
+      const double raw = param->updateValue(id[i], normalized[i]);
+      if (raw != previous) setParameterValue(id[i], raw);
+    }
+    repaint();
+  }
+
   void programLoaded(uint32_t index) override
   {
     param->loadProgram(index);
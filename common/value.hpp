@@ -23,6 +23,9 @@
 
 #include "dsp/scale.hpp"
 
+#include <array>
+#include <atomic>
+#include <memory>
 #include <string>
 
 #ifndef TEST_BUILD
@@ -59,6 +62,7 @@ struct ValueInterface {
   virtual void setParameterRange(Parameter &parameter) = 0;
 #endif
   virtual const char *getName() const = 0;
+  virtual bool isInteger() const = 0;
   virtual double getFloat() const = 0;
   virtual uint32_t getInt() const = 0;
   virtual double getNormalized() = 0;
@@ -69,12 +73,43 @@ struct ValueInterface {
   virtual void setFromNormalized(double value) = 0;
 };
 
+/*
+Names of indexed parameters like `gain0, gain1, ...`, made at compile time. Declare as
+`static constexpr` in `GlobalParameter` constructor, so all instances share a table in
+read-only data instead of building strings. Names longer than `length - 4` are truncated.
+Suffix starts from `offset`, for example 1 for `gain1, gain2, ...`.
+*/
+template<size_t size, size_t length = 32> class IndexedName {
+public:
+  static_assert(size <= 1000, "Index must fit in 3 digits.");
+
+  constexpr IndexedName(const char *prefix, size_t offset = 0) : name{}
+  {
+    for (size_t idx = 0; idx < size; ++idx) {
+      size_t pos = 0;
+      for (; prefix[pos] != '\0' && pos < length - 4; ++pos) name[idx][pos] = prefix[pos];
+
+      const size_t number = (idx + offset) % 1000;
+      if (number >= 100) name[idx][pos++] = char('0' + number / 100);
+      if (number >= 10) name[idx][pos++] = char('0' + number / 10 % 10);
+      name[idx][pos] = char('0' + number % 10);
+    }
+  }
+
+  constexpr const char *operator[](size_t index) const { return name[index]; }
+
+private:
+  char name[size][length];
+};
+
+// `IntValue` and `FloatValue` don't copy `name`. It must be a string literal or an entry
+// of `IndexedName`.
 struct IntValue : public ValueInterface {
   SomeDSP::IntScale<double> &scale;
   double defaultNormalized;
   uint32_t raw;
 
-  std::string name;
+  const char *name;
   uint32_t hints;
 
   IntValue(
@@ -93,14 +128,15 @@ struct IntValue : public ValueInterface {
 #ifndef TEST_BUILD
   void setParameterRange(Parameter &parameter) override
   {
-    parameter.name = name.c_str();
+    parameter.name = name;
     parameter.hints = hints;
     parameter.ranges
       = ScaledParameterRanges<SomeDSP::IntScale<double>>(defaultNormalized, scale);
   }
 #endif
 
-  inline const char *getName() const override { return name.c_str(); }
+  inline const char *getName() const override { return name; }
+  inline bool isInteger() const override { return true; }
   inline uint32_t getInt() const override { return raw; }
   inline double getFloat() const override { return raw; }
   double getNormalized() override { return scale.invmap(raw); }
@@ -130,7 +166,7 @@ template<typename Scale> struct FloatValue : public ValueInterface {
   double defaultNormalized;
   double raw;
   Scale &scale;
-  std::string name;
+  const char *name;
   uint32_t hints;
 
   FloatValue(double defaultNormalized, Scale &scale, const char *name, uint32_t hints)
@@ -145,13 +181,14 @@ template<typename Scale> struct FloatValue : public ValueInterface {
 #ifndef TEST_BUILD
   void setParameterRange(Parameter &parameter) override
   {
-    parameter.name = name.c_str();
+    parameter.name = name;
     parameter.hints = hints;
     parameter.ranges = ScaledParameterRanges<Scale>(defaultNormalized, scale);
   }
 #endif
 
-  inline const char *getName() const override { return name.c_str(); }
+  inline const char *getName() const override { return name; }
+  inline bool isInteger() const override { return false; }
   inline uint32_t getInt() const override { return uint32_t(raw); }
   inline double getFloat() const override { return raw; }
   double getNormalized() override { return scale.invmap(raw); }
@@ -176,3 +213,166 @@ template<typename Scale> struct FloatValue : public ValueInterface {
     raw = scale.map(value);
   }
 };
+
+/*
+Reference to an element of `ParameterStore`. `operator->` returns itself, so code written
+for `std::unique_ptr<ValueInterface>` like `value[id]->getFloat()` works as is.
+*/
+template<typename Raw, typename Meta, typename Flag> class ValueRef {
+public:
+  ValueRef() = default;
+  ValueRef(Raw &raw, Meta &meta, Flag &changed)
+    : raw(&raw), meta(&meta), changed(&changed)
+  {
+  }
+
+  ValueRef *operator->() { return this; }
+  bool operator==(std::nullptr_t) const { return *meta == nullptr; }
+  bool operator!=(std::nullptr_t) const { return *meta != nullptr; }
+
+  template<typename Value> void operator=(std::unique_ptr<Value> &&value)
+  {
+    *meta = std::move(value);
+    sync();
+  }
+
+#ifndef TEST_BUILD
+  void setParameterRange(Parameter &parameter) { (*meta)->setParameterRange(parameter); }
+#endif
+
+  // Audio thread only calls these two. No pointer chase, no virtual call.
+  inline double getFloat() const { return *raw; }
+  inline uint32_t getInt() const { return uint32_t(*raw); }
+
+  const char *getName() const { return (*meta)->getName(); }
+  bool isInteger() const { return (*meta)->isInteger(); }
+  double getNormalized() { return (*meta)->getNormalized(); }
+  uint32_t getDefaultInt() { return (*meta)->getDefaultInt(); }
+  double getDefaultNormalized() { return (*meta)->getDefaultNormalized(); }
+
+  void setFromInt(uint32_t value)
+  {
+    (*meta)->setFromInt(value);
+    sync();
+  }
+
+  void setFromFloat(double value)
+  {
+    (*meta)->setFromFloat(value);
+    sync();
+  }
+
+  void setFromNormalized(double value)
+  {
+    (*meta)->setFromNormalized(value);
+    sync();
+  }
+
+private:
+  void sync()
+  {
+    const auto value = (*meta)->getFloat();
+    if (*raw == value) return;
+    *raw = value;
+    changed->store(true, std::memory_order_release);
+  }
+
+  Raw *raw = nullptr;
+  Meta *meta = nullptr;
+  Flag *changed = nullptr;
+};
+
+/*
+Fixed size parameter storage used as `GlobalParameter::value`.
+
+Raw values are packed in a contiguous array, and `ValueInterface` objects are kept in a
+parallel array as metadata (scale, name, hints). Reading a value is an indexed load from
+the array. Writing goes through metadata to apply scale and clamping, then the result is
+copied back to the array. So raw array and metadata are always in sync.
+
+Metadata is allocated per instance, not shared as a static table, because each
+`ValueInterface` also holds its own copy of the value that setters write. Scales are
+already static in `Scales`. Metadata is allocated once in `GlobalParameter` constructor
+and never touched by `getFloat()` or `getInt()`, so audio thread doesn't pay for it.
+
+Each value also has a dirty flag which is set when a write changes the raw value. Host
+thread may write while audio thread reads, so flags are atomic. DSP calls
+`consumeChanged()` at the start of `setParameters()` to take all flags at once, then
+uses `isChanged()` to skip recomputing the groups of parameters that are not touched.
+A write after `consumeChanged()` stays flagged for the next call. All flags are set on
+construction and by `markChanged()`, so the first `setParameters()` after `setup()` or
+`reset()` recomputes everything.
+*/
+template<size_t length> class ParameterStore {
+public:
+  using Meta = std::unique_ptr<ValueInterface>;
+  using Flag = std::atomic<bool>;
+  using Ref = ValueRef<double, Meta, Flag>;
+  using ConstRef = ValueRef<const double, const Meta, const Flag>;
+
+  class Iterator {
+  public:
+    Iterator(ParameterStore &store, size_t index) : store(store), index(index) {}
+
+    Ref &operator*() { return ref = store[index]; }
+    bool operator!=(const Iterator &rhs) const { return index != rhs.index; }
+
+    Iterator &operator++()
+    {
+      ++index;
+      return *this;
+    }
+
+  private:
+    ParameterStore &store;
+    size_t index;
+    Ref ref;
+  };
+
+  ParameterStore() { markChanged(); }
+
+  inline Ref operator[](size_t index)
+  {
+    return Ref(raw[index], meta[index], changed[index]);
+  }
+
+  inline ConstRef operator[](size_t index) const
+  {
+    return ConstRef(raw[index], meta[index], changed[index]);
+  }
+
+  constexpr size_t size() const { return length; }
+
+  // Audio thread only. Takes the flags set since the last call, and clears them.
+  void consumeChanged()
+  {
+    for (size_t idx = 0; idx < length; ++idx)
+      consumed[idx] = changed[idx].exchange(false, std::memory_order_acquire);
+  }
+
+  // Returns the flag taken by the last `consumeChanged()`.
+  inline bool isChanged(size_t index) const { return consumed[index]; }
+
+  // Returns true if any of the values in [first, last] is changed. `last` is inclusive.
+  bool isChanged(size_t first, size_t last) const
+  {
+    for (size_t idx = first; idx <= last; ++idx) {
+      if (consumed[idx]) return true;
+    }
+    return false;
+  }
+
+  void markChanged()
+  {
+    for (auto &flag : changed) flag.store(true, std::memory_order_release);
+  }
+
+  Iterator begin() { return Iterator(*this, 0); }
+  Iterator end() { return Iterator(*this, length); }
+
+private:
+  alignas(64) std::array<double, length> raw{};
+  std::array<Meta, length> meta;
+  std::array<Flag, length> changed;
+  std::array<bool, length> consumed{};
+};
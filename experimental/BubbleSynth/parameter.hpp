@@ -60,36 +60,33 @@ struct Scales {
 };
 
 struct GlobalParameter : public ParameterInterface {
-  std::vector<std::unique_ptr<ValueInterface>> value;
+  ParameterStore<ParameterID::ID_ENUM_LENGTH> value;
 
   GlobalParameter()
   {
-    value.resize(ParameterID::ID_ENUM_LENGTH);
-
     using ID = ParameterID::ID;
     using LinearValue = FloatValue<SomeDSP::LinearScale<double>>;
     using LogValue = FloatValue<SomeDSP::LogScale<double>>;
 
-    std::string radiusLabel("radius");
-    std::string gainLabel("gain");
-    std::string xiLabel("xi");
-    std::string attackLabel("attack");
-    std::string decayLabel("decay");
-    std::string delayLabel("delay");
+    static constexpr IndexedName<nOscillator> radiusLabel("radius");
+    static constexpr IndexedName<nOscillator> gainLabel("gain");
+    static constexpr IndexedName<nOscillator> xiLabel("xi");
+    static constexpr IndexedName<nOscillator> attackLabel("attack");
+    static constexpr IndexedName<nOscillator> decayLabel("decay");
+    static constexpr IndexedName<nOscillator> delayLabel("delay");
     for (size_t idx = 0; idx < nOscillator; ++idx) {
-      auto indexStr = std::to_string(idx);
       value[ID::radius0 + idx] = std::make_unique<LogValue>(
-        0.5, Scales::radius, (radiusLabel + indexStr).c_str(), kParameterIsAutomable);
+        0.5, Scales::radius, radiusLabel[idx], kParameterIsAutomable);
       value[ID::gain0 + idx] = std::make_unique<LogValue>(
-        0.5, Scales::gain, (gainLabel + indexStr).c_str(), kParameterIsAutomable);
+        0.5, Scales::gain, gainLabel[idx], kParameterIsAutomable);
       value[ID::xi0 + idx] = std::make_unique<LinearValue>(
-        0.0, Scales::xi, (xiLabel + indexStr).c_str(), kParameterIsAutomable);
+        0.0, Scales::xi, xiLabel[idx], kParameterIsAutomable);
       value[ID::attack0 + idx] = std::make_unique<LogValue>(
-        0.5, Scales::attack, (attackLabel + indexStr).c_str(), kParameterIsAutomable);
+        0.5, Scales::attack, attackLabel[idx], kParameterIsAutomable);
       value[ID::decay0 + idx] = std::make_unique<LogValue>(
-        0.5, Scales::decay, (decayLabel + indexStr).c_str(), kParameterIsAutomable);
+        0.5, Scales::decay, decayLabel[idx], kParameterIsAutomable);
       value[ID::delay0 + idx] = std::make_unique<LogValue>(
-        0.0, Scales::delay, (delayLabel + indexStr).c_str(), kParameterIsAutomable);
+        0.0, Scales::delay, delayLabel[idx], kParameterIsAutomable);
     }
 
     value[ID::bypass] = std::make_unique<IntValue>(
@@ -84,43 +84,37 @@ struct Scales {
 };
 
 struct GlobalParameter : public ParameterInterface {
-  std::vector<std::unique_ptr<ValueInterface>> value;
+  ParameterStore<ParameterID::ID_ENUM_LENGTH> value;
 
   GlobalParameter()
   {
-    value.resize(ParameterID::ID_ENUM_LENGTH);
-
     using ID = ParameterID::ID;
     using LinearValue = FloatValue<SomeDSP::LinearScale<double>>;
     using LogValue = FloatValue<SomeDSP::LogScale<double>>;
 
-    std::string gainLabel("gain");
-    std::string decayLabel("decay");
-    std::string pitchLabel("pitch");
-    std::string couplingLabel("coupling");
-    std::string couplingDecayLabel("couplingDecay");
+    static constexpr IndexedName<nOscillator> gainLabel("gain");
+    static constexpr IndexedName<nOscillator> decayLabel("decay");
+    static constexpr IndexedName<nOscillator> pitchLabel("pitch");
+    static constexpr IndexedName<nOscillator> couplingLabel("coupling");
+    static constexpr IndexedName<nOscillator> couplingDecayLabel("couplingDecay");
     for (size_t idx = 0; idx < nOscillator; ++idx) {
-      auto indexStr = std::to_string(idx);
       value[ID::gain0 + idx] = std::make_unique<LogValue>(
-        0.5, Scales::gain, (gainLabel + indexStr).c_str(), kParameterIsAutomable);
+        0.5, Scales::gain, gainLabel[idx], kParameterIsAutomable);
       value[ID::decay0 + idx] = std::make_unique<LogValue>(
-        0.5, Scales::decay, (decayLabel + indexStr).c_str(), kParameterIsAutomable);
+        0.5, Scales::decay, decayLabel[idx], kParameterIsAutomable);
       value[ID::pitch0 + idx] = std::make_unique<LinearValue>(
-        0.5, Scales::pitch, (pitchLabel + indexStr).c_str(), kParameterIsAutomable);
+        0.5, Scales::pitch, pitchLabel[idx], kParameterIsAutomable);
       value[ID::coupling0 + idx] = std::make_unique<LogValue>(
-        0.25, Scales::coupling, (couplingLabel + indexStr).c_str(),
-        kParameterIsAutomable);
+        0.25, Scales::coupling, couplingLabel[idx], kParameterIsAutomable);
       value[ID::couplingDecay0 + idx] = std::make_unique<LinearValue>(
-        0.0, Scales::defaultScale, (couplingDecayLabel + indexStr).c_str(),
-        kParameterIsAutomable);
+        0.0, Scales::defaultScale, couplingDecayLabel[idx], kParameterIsAutomable);
     }
 
-    std::string waveformLabel("waveform");
+    static constexpr IndexedName<nWaveform> waveformLabel("waveform");
     for (size_t idx = 0; idx < nWaveform; ++idx) {
-      auto indexStr = std::to_string(idx);
       value[ID::waveform0 + idx] = std::make_unique<LinearValue>(
         Scales::waveform.invmap(sin(SomeDSP::twopi * idx / double(nWaveform))),
-        Scales::waveform, (waveformLabel + indexStr).c_str(), kParameterIsAutomable);
+        Scales::waveform, waveformLabel[idx], kParameterIsAutomable);
     }
 
     value[ID::bypass] = std::make_unique<IntValue>(
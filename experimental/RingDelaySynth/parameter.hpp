@@ -78,12 +78,10 @@ struct Scales {
 };
 
 struct GlobalParameter : public ParameterInterface {
-  std::vector<std::unique_ptr<ValueInterface>> value;
+  ParameterStore<ParameterID::ID_ENUM_LENGTH> value;
 
   GlobalParameter()
   {
-    value.resize(ParameterID::ID_ENUM_LENGTH);
-
     using ID = ParameterID::ID;
     using LinearValue = FloatValue<SomeDSP::LinearScale<double>>;
     using LogValue = FloatValue<SomeDSP::LogScale<double>>;
@@ -91,12 +89,10 @@ struct GlobalParameter : public ParameterInterface {
     value[ID::bypass] = std::make_unique<IntValue>(
       false, Scales::boolScale, "bypass", kParameterIsAutomable | kParameterIsBoolean);
 
-    std::string frequencyLabel("frequency");
+    static constexpr IndexedName<nDelay> frequencyLabel("frequency");
     for (size_t idx = 0; idx < nDelay; ++idx) {
-      auto indexStr = std::to_string(idx);
       value[ID::frequency0 + idx] = std::make_unique<LogValue>(
-        0.5, Scales::frequency, (frequencyLabel + indexStr).c_str(),
-        kParameterIsAutomable);
+        0.5, Scales::frequency, frequencyLabel[idx], kParameterIsAutomable);
     }
 
     value[ID::gain] = std::make_unique<LogValue>(
@@ -56,28 +56,24 @@ struct Scales {
 };
 
 struct GlobalParameter : public ParameterInterface {
-  std::vector<std::unique_ptr<ValueInterface>> value;
+  ParameterStore<ParameterID::ID_ENUM_LENGTH> value;
 
   GlobalParameter()
   {
-    value.resize(ParameterID::ID_ENUM_LENGTH);
-
     using ID = ParameterID::ID;
     using LinearValue = FloatValue<SomeDSP::LinearScale<double>>;
     using LogValue = FloatValue<SomeDSP::LogScale<double>>;
 
-    std::string gainLabel("gain");
-    std::string delayLabel("delay");
-    std::string typeLabel("type");
+    static constexpr IndexedName<nGate> gainLabel("gain", 1);
+    static constexpr IndexedName<nGate> delayLabel("delay", 1);
+    static constexpr IndexedName<nGate> typeLabel("type", 1);
     for (size_t idx = 0; idx < nGate; ++idx) {
-      auto indexStr = std::to_string(idx + 1);
       value[ID::gain1 + idx] = std::make_unique<LinearValue>(
-        1.0, Scales::gain, (gainLabel + indexStr).c_str(), kParameterIsAutomable);
+        1.0, Scales::gain, gainLabel[idx], kParameterIsAutomable);
       value[ID::delay1 + idx] = std::make_unique<LinearValue>(
-        0.0, Scales::delay, (delayLabel + indexStr).c_str(), kParameterIsAutomable);
+        0.0, Scales::delay, delayLabel[idx], kParameterIsAutomable);
       value[ID::type1 + idx] = std::make_unique<IntValue>(
-        1, Scales::type, (typeLabel + indexStr).c_str(),
-        kParameterIsAutomable | kParameterIsInteger);
+        1, Scales::type, typeLabel[idx], kParameterIsAutomable | kParameterIsInteger);
     }
 
     value[ID::masterGain] = std::make_unique<LinearValue>(
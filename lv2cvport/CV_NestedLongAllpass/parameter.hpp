@@ -57,28 +57,25 @@ struct Scales {
 };
 
 struct GlobalParameter : public ParameterInterface {
-  std::vector<std::unique_ptr<ValueInterface>> value;
+  ParameterStore<ParameterID::ID_ENUM_LENGTH> value;
 
   GlobalParameter()
   {
-    value.resize(ParameterID::ID_ENUM_LENGTH);
-
     using ID = ParameterID::ID;
     using LinearValue = FloatValue<SomeDSP::LinearScale<double>>;
     using LogValue = FloatValue<SomeDSP::LogScale<double>>;
 
-    std::string timeLabel("time");
-    std::string outerFeedLabel("outerFeed");
-    std::string innerFeedLabel("innerFeed");
+    static constexpr IndexedName<nestingDepth> timeLabel("time");
+    static constexpr IndexedName<nestingDepth> outerFeedLabel("outerFeed");
+    static constexpr IndexedName<nestingDepth> innerFeedLabel("innerFeed");
     for (size_t idx = 0; idx < nestingDepth; ++idx) {
-      auto indexStr = std::to_string(idx);
       value[ID::time0 + idx] = std::make_unique<LogValue>(
-        Scales::time.invmap(0.1), Scales::time, (timeLabel + indexStr).c_str(),
+        Scales::time.invmap(0.1), Scales::time, timeLabel[idx],
         kParameterIsAutomable | kParameterIsLogarithmic);
       value[ID::outerFeed0 + idx] = std::make_unique<LinearValue>(
-        0.5, Scales::feed, (outerFeedLabel + indexStr).c_str(), kParameterIsAutomable);
+        0.5, Scales::feed, outerFeedLabel[idx], kParameterIsAutomable);
       value[ID::innerFeed0 + idx] = std::make_unique<LinearValue>(
-        0.5, Scales::feed, (innerFeedLabel + indexStr).c_str(), kParameterIsAutomable);
+        0.5, Scales::feed, innerFeedLabel[idx], kParameterIsAutomable);
     }
 
     value[ID::timeMultiply] = std::make_unique<LinearValue>(
@@ -0,0 +1,91 @@
+import json
+import struct
+import sys
+
+from collections import OrderedDict
+from pathlib import Path
+
+NAME_SIZE = 64
+HEADER_SIZE = 64
+
+def align(value, alignment):
+    return (value + alignment - 1) // alignment * alignment
+
+def json_to_bank(type_json_path, preset_json_path):
+    """
+    Write `*.preset.json` to preset bank file which is read by `common/presetbank.hpp`.
+
+    Order of parameters in `*.type.json` must be the same as `ParameterID::ID`, as same
+    as `jsontovstpreset.py`. Missing parameters in a preset are filled by default value.
+    """
+    with open(preset_json_path, "r", encoding="utf-8") as fi:
+        preset_list = json.load(fi)
+
+    with open(type_json_path, "r", encoding="utf-8") as fi:
+        type_data = json.load(fi, object_pairs_hook=OrderedDict)
+
+    n_parameter = len(type_data)
+    n_preset = len(preset_list)
+
+    type_offset = HEADER_SIZE
+    name_offset = type_offset + n_parameter
+    value_offset = align(name_offset + n_preset * NAME_SIZE, 64)
+
+    header = b"UHYPBANK"
+    header += struct.pack("<IIII", 1, n_parameter, n_preset, NAME_SIZE)
+    header += struct.pack("<QQQ", type_offset, name_offset, value_offset)
+    header += bytes(HEADER_SIZE - len(header))
+
+    types = bytes(1 if elem["type"] == "I" else 0 for elem in type_data.values())
+
+    names = bytearray()
+    for preset in preset_list:
+        name = preset["name"].encode("utf-8")[:NAME_SIZE - 1]
+        names += name + bytes(NAME_SIZE - len(name))
+    padding = bytes(value_offset - name_offset - len(names))
+
+    values = bytearray()
+    for preset in preset_list:
+        parameter = preset["parameter"]
+        for param_name, elem in type_data.items():
+            value = parameter.get(param_name, elem["default"])
+            if isinstance(value, str):
+                raise ValueError(
+                    f"{param_name} is missing in {preset['name']}, and its default "
+                    f"value {value} is not a number.")
+            if param_name == "bypass":
+                value = 0
+
+            if elem["type"] == "I":
+                values += struct.pack("<I", int(value))
+            else:
+                values += struct.pack("<f", float(value))
+
+    plugin_name = preset_json_path.name.split(".")[0]
+    out_dir = Path(__file__).parent / Path("bank")
+    out_dir.mkdir(parents=True, exist_ok=True)
+    with open(out_dir / Path(f"{plugin_name}.bank"), "wb") as fi:
+        fi.write(header + types + names + padding + values)
+
+if __name__ == "__main__":
+    if len(sys.argv) < 2:
+        print("Requires plugin name as first argument.")
+        exit(1)
+
+    if len(sys.argv) > 2:
+        print("Only first argument is used. Second or later arguments are discarded.")
+
+    plugin_name = sys.argv[1]
+    json_dir = Path(__file__).parent / Path("json")
+
+    type_json_path = json_dir / Path(f"{plugin_name}.type.json")
+    if not type_json_path.exists():
+        print(f"{str(type_json_path)} doesn't exist.")
+        exit(1)
+
+    preset_json_path = json_dir / Path(f"{plugin_name}.preset.json")
+    if not preset_json_path.exists():
+        print(f"{str(preset_json_path)} doesn't exist.")
+        exit(1)
+
+    json_to_bank(type_json_path, preset_json_path)
@@ -19,24 +19,19 @@ def json_to_cpp(type_json_path, preset_json_path, prefix="preset"):
 
     indent = "  "
 
-    # loadProgram() method
+    # Preset table and loadProgram() method.
     code = """#include "parameter.hpp"
+#include "../common/preset.hpp"
+
+#include <iterator>
 
 // Generated from preset dump.
 #ifndef TEST_BUILD
 
-void GlobalParameter::loadProgram(uint32_t index)
-{
-  using ID = ParameterID::ID;
-
-  switch (index) {
-    default:
-      resetParameter();
-      break;
+using ID = ParameterID::ID;
 """
     for preset in preset_list:
-        name = preset["name"]
-        code += f"\n{indent * 2}case {prefix + name}: {{\n"
+        code += f"\nstatic const PresetEntry {prefix + preset['name']}Entry[] = {{\n"
         for name, value in preset["parameter"].items():
             dtype = parameter_type[name]["type"]
             index = parameter_type[name]["index"]
@@ -44,14 +39,30 @@ void GlobalParameter::loadProgram(uint32_t index)
                 value = 0
 
             if dtype == "I":
-                code += f"{indent * 3}value[ID::{index}]->setFromInt({value});\n"
-            elif dtype == "d":
-                code += f"{indent * 3}value[ID::{index}]->setFromNormalized({value});\n"
+                code += f"{indent}{{ID::{index}, 1, {float(value)}}},\n"
             else:
-                code += f"{indent * 3}value[ID::{index}]->setFromNormalized({value});\n"
+                code += f"{indent}{{ID::{index}, 0, {value}}},\n"
+        code += "};\n"
 
-        code += f"{indent * 2}}} break;\n"
-    code += f"{indent}}}\n}}\n\n#endif\n"
+    code += """
+void GlobalParameter::loadProgram(uint32_t index)
+{
+  static const std::array<PresetData, Preset_ENUM_LENGTH> presetData{{
+"""
+    for preset in preset_list:
+        entry = f"{prefix + preset['name']}Entry"
+        code += f"{indent * 2}{{{entry}, std::size({entry})}},\n"
+    code += """  }};
+
+  if (index >= presetData.size()) {
+    resetParameter();
+    return;
+  }
+  loadPresetData(value, presetData[index]);
+}
+
+#endif
+"""
 
     out_dir = Path(__file__).parent / Path("cpp")
     out_dir.mkdir(parents=True, exist_ok=True)